@@ -1,7 +1,6 @@
 #include <AStar.hpp>
-#include <RobotWorld.hpp>
-#include <Shape2DUtils.hpp>
-#include <Wall.hpp>
+#include <Landmarks.hpp>
+#include <OccupancyGrid.hpp>
 #include <algorithm>
 #include <cmath>
 #include <iterator>
@@ -11,89 +10,489 @@
 
 namespace PathAlgorithm
 {
+	/* static */const int FourConnected::xOffset[] = { 0, 1, 0, -1 };
+	/* static */const int FourConnected::yOffset[] = { 1, 0, -1, 0 };
+	/* static */const Cost FourConnected::stepCost[] = { StraightCost, StraightCost, StraightCost, StraightCost };
+	/* static */const int EightConnected::xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+	/* static */const int EightConnected::yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+	/* static */const Cost EightConnected::stepCost[] = { StraightCost, DiagonalCost, StraightCost, DiagonalCost, StraightCost, DiagonalCost, StraightCost, DiagonalCost };
 	/**
-	 *
+	 * The length in pixels of the straight line from aStart to aGoal
 	 */
-	double ActualCost(	const Vertex& aStart,
-						const Vertex& aGoal)
+	double ActualCost(	const Point& aStart,
+						const Point& aGoal)
 	{
 		return std::sqrt( (aStart.x - aGoal.x) * (aStart.x - aGoal.x) + (aStart.y - aGoal.y) * (aStart.y - aGoal.y));
 	}
+	/**
+	 * The fixed point cost of the straight line from aStart to aGoal, rounded up as DiagonalCost is
+	 */
+	Cost LineCost(	const Point& aStart,
+					const Point& aGoal)
+	{
+		return static_cast< Cost >( std::ceil( ActualCost( aStart, aGoal) * StraightCost));
+	}
+	/**
+	 * The fixed point cost of a straight or diagonal line, as taken by a jump of Jump Point Search
+	 */
+	Cost JumpCost(	const Point& aStart,
+					const Point& aGoal)
+	{
+		return OctileHeuristic::estimate( aGoal.x - aStart.x, aGoal.y - aStart.y);
+	}
 	/**
 	 *
 	 */
-	double HeuristicCost(	const Vertex& aStart,
-							const Vertex& aGoal)
+	void ConstructPath(	const SearchGrid& aSearchGrid,
+						std::uint32_t aCurrentNode,
+						bool anAnyAngle,
+						Path& aPath)
 	{
-		return std::sqrt( (aStart.x - aGoal.x) * (aStart.x - aGoal.x) + (aStart.y - aGoal.y) * (aStart.y - aGoal.y));
+		aPath.clear();
+		if (anAnyAngle)
+		{
+			// The predecessors are the end points of straight segments in any direction
+			for (std::uint32_t node = aCurrentNode; node != SearchGrid::NoCell; node = aSearchGrid.getParent( node))
+			{
+				aPath.push_back( aSearchGrid.pointOf( node));
+			}
+			aPath.reverse();
+			return;
+		}
+
+		// A predecessor need not be a neighbour (Jump Point Search): the cells in between are on the
+		// straight or diagonal line between them and are added as well
+		std::size_t length = 1;
+		for (std::uint32_t node = aCurrentNode; aSearchGrid.getParent( node) != SearchGrid::NoCell; node = aSearchGrid.getParent( node))
+		{
+			Point point = aSearchGrid.pointOf( node);
+			Point parentPoint = aSearchGrid.pointOf( aSearchGrid.getParent( node));
+			length += std::max( std::abs( point.x - parentPoint.x), std::abs( point.y - parentPoint.y));
+		}
+
+		aPath.reserve( length);
+		for (std::uint32_t node = aCurrentNode; node != SearchGrid::NoCell; node = aSearchGrid.getParent( node))
+		{
+			Point point = aSearchGrid.pointOf( node);
+			aPath.push_back( point);
+
+			std::uint32_t parent = aSearchGrid.getParent( node);
+			if (parent != SearchGrid::NoCell)
+			{
+				Point parentPoint = aSearchGrid.pointOf( parent);
+				int dx = (parentPoint.x > point.x) - (parentPoint.x < point.x);
+				int dy = (parentPoint.y > point.y) - (parentPoint.y < point.y);
+				int steps = std::max( std::abs( parentPoint.x - point.x), std::abs( parentPoint.y - point.y));
+				for (int step = 1; step < steps; ++step)
+				{
+					aPath.push_back( Point( point.x + step * dx, point.y + step * dy));
+				}
+			}
+		}
+		aPath.reverse();
 	}
 	/**
 	 *
 	 */
-	Path ConstructPath(	VertexMap& aPredecessorMap,
-						const Vertex& aCurrentNode)
+	void OpenSet::clear()
 	{
-		VertexMap::iterator i = aPredecessorMap.find( aCurrentNode);
-		if (i != aPredecessorMap.end())
+		for (std::uint32_t cell : cells)
 		{
-			Path path = ConstructPath( aPredecessorMap, (*i).second);
-			path.push_back( aCurrentNode);
-			return path;
+			searchGrid.at( cell).state = SearchGrid::Unvisited;
+		}
+		keys.clear();
+		cells.clear();
+	}
+	/**
+	 *
+	 */
+	void OpenSet::pop()
+	{
+		removeAt( 0);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::push(	std::uint32_t aCell,
+						Cost anEstimate,
+						Cost anActualCost)
+	{
+		searchGrid.at( aCell).state = SearchGrid::Open;
+		keys.push_back( makeKey( anEstimate, anActualCost));
+		cells.push_back( aCell);
+		siftUp( cells.size() - 1);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::update(	std::uint32_t aCell,
+							Cost anEstimate,
+							Cost anActualCost)
+	{
+		SearchGrid::Cell cell = searchGrid.at( aCell);
+		if (cell.state != SearchGrid::Open)
+		{
+			throw std::logic_error( "OpenSet::update: cell not in the open set");
+		}
+		std::size_t slot = cell.heapSlot;
+		keys[slot] = makeKey( anEstimate, anActualCost);
+		siftUp( slot);
+		siftDown( slot);
+	}
+	/**
+	 *
+	 */
+	bool OpenSet::remove( std::uint32_t aCell)
+	{
+		if (!contains( aCell))
+		{
+			return false;
+		}
+		removeAt( searchGrid.at( aCell).heapSlot);
+		return true;
+	}
+	/**
+	 *
+	 */
+	void OpenSet::siftUp( std::size_t aSlot)
+	{
+		std::uint64_t key = keys[aSlot];
+		std::uint32_t cell = cells[aSlot];
+		while (aSlot > 0)
+		{
+			std::size_t parent = (aSlot - 1) / 2;
+			if (key >= keys[parent])
+			{
+				break;
+			}
+			place( aSlot, keys[parent], cells[parent]);
+			aSlot = parent;
+		}
+		place( aSlot, key, cell);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::siftDown( std::size_t aSlot)
+	{
+		std::uint64_t key = keys[aSlot];
+		std::uint32_t cell = cells[aSlot];
+		const std::size_t size = keys.size();
+		for (;;)
+		{
+			std::size_t child = 2 * aSlot + 1;
+			if (child >= size)
+			{
+				break;
+			}
+			if (child + 1 < size && keys[child + 1] < keys[child])
+			{
+				++child;
+			}
+			if (keys[child] >= key)
+			{
+				break;
+			}
+			place( aSlot, keys[child], cells[child]);
+			aSlot = child;
+		}
+		place( aSlot, key, cell);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::place(	std::size_t aSlot,
+							std::uint64_t aKey,
+							std::uint32_t aCell)
+	{
+		keys[aSlot] = aKey;
+		cells[aSlot] = aCell;
+		searchGrid.at( aCell).heapSlot = static_cast< std::uint32_t >( aSlot);
+	}
+	/**
+	 *
+	 */
+	void OpenSet::removeAt( std::size_t aSlot)
+	{
+		searchGrid.at( cells[aSlot]).state = SearchGrid::Unvisited;
+		if (aSlot + 1 != cells.size())
+		{
+			place( aSlot, keys.back(), cells.back());
+			keys.pop_back();
+			cells.pop_back();
+			siftUp( aSlot);
+			siftDown( aSlot);
 		} else
 		{
-			Path path;
-			path.push_back( aCurrentNode);
-			return path;
+			keys.pop_back();
+			cells.pop_back();
 		}
 	}
 	/**
 	 *
 	 */
-	std::vector< Vertex > GetNeighbours(	const Vertex& aVertex,
-											int aFreeRadius /*= 1*/)
+	inline bool IsWalkable(	int anX,
+							int anY,
+							const OccupancyGrid& anOccupancyGrid,
+							const SearchGrid& aSearchGrid)
+	{
+		return aSearchGrid.contains( anX, anY) && !anOccupancyGrid.isBlocked( anX, anY);
+	}
+	/**
+	 * Moves from (anX,anY) in direction (aDx,aDy) until a jump point is found: the goal or a cell with a
+	 * forced neighbour, i.e. a neighbour that can only be reached optimally through that cell. A diagonal
+	 * move also stops at a cell from which a straight jump finds a jump point.
+	 *
+	 * @return true and the jump point in aJumpPoint if one is found before hitting a blocked cell
+	 */
+	bool Jump(	int anX,
+				int anY,
+				int aDx,
+				int aDy,
+				const Point& aGoal,
+				const OccupancyGrid& anOccupancyGrid,
+				const SearchGrid& aSearchGrid,
+				Point& aJumpPoint)
+	{
+		for (;;)
+		{
+			anX += aDx;
+			anY += aDy;
+			if (!IsWalkable( anX, anY, anOccupancyGrid, aSearchGrid))
+			{
+				return false;
+			}
+			if (anX == aGoal.x && anY == aGoal.y)
+			{
+				aJumpPoint = Point( anX, anY);
+				return true;
+			}
+			if (aDx != 0 && aDy != 0)
+			{
+				if ((!IsWalkable( anX - aDx, anY, anOccupancyGrid, aSearchGrid) && IsWalkable( anX - aDx, anY + aDy, anOccupancyGrid, aSearchGrid)) ||
+					(!IsWalkable( anX, anY - aDy, anOccupancyGrid, aSearchGrid) && IsWalkable( anX + aDx, anY - aDy, anOccupancyGrid, aSearchGrid)))
 				{
-		static int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
-		static int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
-
-		const std::vector< Model::WallPtr >& walls = Model::RobotWorld::getRobotWorld().getWalls();
-		std::vector< Vertex > neighbours;
+					aJumpPoint = Point( anX, anY);
+					return true;
+				}
+				Point straightJumpPoint;
+				if (Jump( anX, anY, aDx, 0, aGoal, anOccupancyGrid, aSearchGrid, straightJumpPoint) ||
+					Jump( anX, anY, 0, aDy, aGoal, anOccupancyGrid, aSearchGrid, straightJumpPoint))
+				{
+					aJumpPoint = Point( anX, anY);
+					return true;
+				}
+			} else if (aDx != 0)
+			{
+				if ((!IsWalkable( anX, anY + 1, anOccupancyGrid, aSearchGrid) && IsWalkable( anX + aDx, anY + 1, anOccupancyGrid, aSearchGrid)) ||
+					(!IsWalkable( anX, anY - 1, anOccupancyGrid, aSearchGrid) && IsWalkable( anX + aDx, anY - 1, anOccupancyGrid, aSearchGrid)))
+				{
+					aJumpPoint = Point( anX, anY);
+					return true;
+				}
+			} else
+			{
+				if ((!IsWalkable( anX + 1, anY, anOccupancyGrid, aSearchGrid) && IsWalkable( anX + 1, anY + aDy, anOccupancyGrid, aSearchGrid)) ||
+					(!IsWalkable( anX - 1, anY, anOccupancyGrid, aSearchGrid) && IsWalkable( anX - 1, anY + aDy, anOccupancyGrid, aSearchGrid)))
+				{
+					aJumpPoint = Point( anX, anY);
+					return true;
+				}
+			}
+		}
+	}
+	/**
+	 * The successors of an expanded cell, at most one per direction. They are kept in a fixed size
+	 * array on the stack of the search, so generating them does not allocate.
+	 */
+	struct Successors
+	{
+			Successors() :
+				count( 0)
+			{
+			}
+			void add( const Point& aPoint)
+			{
+				points[count++] = aPoint;
+			}
 
-		for (int i = 0; i < 8; ++i)
+			Point points[EightConnected::numberOfNeighbours];
+			int count;
+	};
+	/**
+	 * The neighbours of aVertex for Jump Point Search: they are pruned on the direction in which
+	 * aVertex was reached (all 8 for the start) and every remaining direction is followed to the next
+	 * jump point, which is added to aJumpPoints.
+	 */
+	void GetJumpPoints(	const Point& aVertex,
+						std::uint32_t aParent,
+						const Point& aGoal,
+						const OccupancyGrid& anOccupancyGrid,
+						const SearchGrid& aSearchGrid,
+						Successors& aJumpPoints)
+	{
+		if (aParent == SearchGrid::NoCell)
 		{
-			bool addToNeigbours = true;
-
-			Vertex vertex( aVertex.x + xOffset[i], aVertex.y + yOffset[i]);
-			for (Model::WallPtr wall : walls)
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
 			{
-				if (Utils::Shape2DUtils::isOnLine( wall->getPoint1(), wall->getPoint2(), vertex.asPoint(), aFreeRadius))
+				Point jumpPoint;
+				if (Jump( aVertex.x, aVertex.y, EightConnected::xOffset[i], EightConnected::yOffset[i], aGoal, anOccupancyGrid, aSearchGrid, jumpPoint))
 				{
-					addToNeigbours = false;
-					break;
+					aJumpPoints.add( jumpPoint);
 				}
 			}
-			if (addToNeigbours == true)
+			return;
+		}
+
+		Point parent = aSearchGrid.pointOf( aParent);
+		int dx = (aVertex.x > parent.x) - (aVertex.x < parent.x);
+		int dy = (aVertex.y > parent.y) - (aVertex.y < parent.y);
+
+		int directions[5][2];
+		int numberOfDirections = 0;
+		if (dx != 0 && dy != 0)
+		{
+			// natural neighbours
+			directions[numberOfDirections][0] = 0, directions[numberOfDirections++][1] = dy;
+			directions[numberOfDirections][0] = dx, directions[numberOfDirections++][1] = 0;
+			directions[numberOfDirections][0] = dx, directions[numberOfDirections++][1] = dy;
+			// forced neighbours
+			if (!IsWalkable( aVertex.x - dx, aVertex.y, anOccupancyGrid, aSearchGrid))
+			{
+				directions[numberOfDirections][0] = -dx, directions[numberOfDirections++][1] = dy;
+			}
+			if (!IsWalkable( aVertex.x, aVertex.y - dy, anOccupancyGrid, aSearchGrid))
+			{
+				directions[numberOfDirections][0] = dx, directions[numberOfDirections++][1] = -dy;
+			}
+		} else if (dx != 0)
+		{
+			directions[numberOfDirections][0] = dx, directions[numberOfDirections++][1] = 0;
+			if (!IsWalkable( aVertex.x, aVertex.y + 1, anOccupancyGrid, aSearchGrid))
+			{
+				directions[numberOfDirections][0] = dx, directions[numberOfDirections++][1] = 1;
+			}
+			if (!IsWalkable( aVertex.x, aVertex.y - 1, anOccupancyGrid, aSearchGrid))
+			{
+				directions[numberOfDirections][0] = dx, directions[numberOfDirections++][1] = -1;
+			}
+		} else
+		{
+			directions[numberOfDirections][0] = 0, directions[numberOfDirections++][1] = dy;
+			if (!IsWalkable( aVertex.x + 1, aVertex.y, anOccupancyGrid, aSearchGrid))
 			{
-				neighbours.push_back( vertex);
+				directions[numberOfDirections][0] = 1, directions[numberOfDirections++][1] = dy;
+			}
+			if (!IsWalkable( aVertex.x - 1, aVertex.y, anOccupancyGrid, aSearchGrid))
+			{
+				directions[numberOfDirections][0] = -1, directions[numberOfDirections++][1] = dy;
 			}
 		}
-		return neighbours;
-				}
+
+		for (int i = 0; i < numberOfDirections; ++i)
+		{
+			Point jumpPoint;
+			if (Jump( aVertex.x, aVertex.y, directions[i][0], directions[i][1], aGoal, anOccupancyGrid, aSearchGrid, jumpPoint))
+			{
+				aJumpPoints.add( jumpPoint);
+			}
+		}
+	}
 	/**
-	 *
+	 * Lazy Theta* assumes that the predecessor of a cell is in line of sight when the cell is opened and
+	 * checks it when the cell is expanded. If it is not, the predecessor becomes the closed neighbour
+	 * through which the cell is reached cheapest, which is always in line of sight.
 	 */
-	std::vector< Edge > GetNeighbourConnections(	const Vertex& aVertex,
-													int aFreeRadius /*= 1*/)
-				{
-		std::vector< Edge > connections;
-
-		const std::vector< Vertex >& neighbours = GetNeighbours( aVertex, aFreeRadius);
-		for (const Vertex& vertex : neighbours)
+	void SetVertex(	const Point& aVertex,
+					std::uint32_t anIndex,
+					const OccupancyGrid& anOccupancyGrid,
+					SearchGrid& aSearchGrid)
+	{
+		SearchGrid::Cell cell = aSearchGrid.at( anIndex);
+		if (cell.parent == SearchGrid::NoCell || anOccupancyGrid.isLineFree( aSearchGrid.pointOf( cell.parent), aVertex))
 		{
-			connections.push_back( Edge( aVertex, vertex));
+			return;
 		}
 
-		return connections;
+		std::uint32_t bestParent = SearchGrid::NoCell;
+		Cost bestCost = 0;
+		for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+		{
+			Point neighbour( aVertex.x + EightConnected::xOffset[i], aVertex.y + EightConnected::yOffset[i]);
+			if (!aSearchGrid.contains( neighbour.x, neighbour.y))
+			{
+				continue;
+			}
+			std::uint32_t neighbourIndex = aSearchGrid.indexOf( neighbour.x, neighbour.y);
+			if (aSearchGrid.getState( neighbourIndex) == SearchGrid::Closed)
+			{
+				Cost cost = aSearchGrid.getActualCost( neighbourIndex) + LineCost( neighbour, aVertex);
+				if (bestParent == SearchGrid::NoCell || cost < bestCost)
+				{
+					bestParent = neighbourIndex;
+					bestCost = cost;
 				}
+			}
+		}
+		if (bestParent != SearchGrid::NoCell)
+		{
+			cell.parent = bestParent;
+			cell.actualCost = bestCost;
+		}
+	}
+	/**
+	 *
+	 */
+	AStar::AStar() :
+								strategy( Standard),
+								progressExpansionInterval( 0),
+								progressTimeInterval( 0),
+								expansionCount( 0),
+								lastProgressExpansion( 0),
+								cancellationFlag( nullptr),
+								timeBudget( 0),
+								outcome( NoRoute),
+								useLandmarks( false),
+								openSet( searchGrid)
+	{
+	}
+	/**
+	 *
+	 */
+	void AStar::setStrategy( Strategy aStrategy)
+	{
+		strategy = aStrategy;
+	}
+	/**
+	 *
+	 */
+	void AStar::setCancellationFlag( const std::atomic< bool >* aFlag)
+	{
+		cancellationFlag = aFlag;
+	}
+	/**
+	 *
+	 */
+	void AStar::setTimeBudget( std::chrono::milliseconds aTimeBudget)
+	{
+		timeBudget = aTimeBudget;
+	}
+	/**
+	 *
+	 */
+	void AStar::setUseLandmarks( bool aUseLandmarks)
+	{
+		useLandmarks = aUseLandmarks;
+	}
+	/**
+	 *
+	 */
+	void AStar::setProgressInterval(	unsigned long anExpansionInterval,
+										std::chrono::milliseconds aTimeInterval)
+	{
+		progressExpansionInterval = anExpansionInterval;
+		progressTimeInterval = aTimeInterval;
+	}
 	/**
 	 *
 	 */
@@ -101,10 +500,8 @@ namespace PathAlgorithm
 						const Point& aGoalPoint,
 						const Size& aRobotSize)
 	{
-		Vertex start( aStartPoint);
-		Vertex goal( aGoalPoint);
-
-		Path path = AStar::search( start, goal, aRobotSize);
+		Path path;
+		search( Vertex( aStartPoint), Vertex( aGoalPoint), aRobotSize, path);
 		return path;
 	}
 	/**
@@ -114,113 +511,175 @@ namespace PathAlgorithm
 						const Vertex& aGoal,
 						const Size& aRobotSize)
 	{
+		Path path;
+		search( aStart, aGoal, aRobotSize, path);
+		return path;
+	}
+	/**
+	 *
+	 */
+	bool AStar::search(	const Point& aStartPoint,
+						const Point& aGoalPoint,
+						const Size& aRobotSize,
+						Path& aPath)
+	{
+		return search( Vertex( aStartPoint), Vertex( aGoalPoint), aRobotSize, aPath);
+	}
+	/**
+	 *
+	 */
+	bool AStar::search( Vertex aStart,
+						const Vertex& aGoal,
+						const Size& aRobotSize,
+						Path& aPath)
+	{
+		// The octile distance overestimates the cost of an any-angle route
+		if (strategy == LazyThetaStar)
+		{
+			return searchWith< EightConnected, EuclideanHeuristic >( aStart, aGoal, aRobotSize, aPath);
+		}
+		return searchWith< EightConnected, OctileHeuristic >( aStart, aGoal, aRobotSize, aPath);
+	}
+	/**
+	 *
+	 */
+	template< typename Connectivity, typename Heuristic >
+	bool AStar::searchWith(	Vertex aStart,
+							const Vertex& aGoal,
+							const Size& aRobotSize,
+							Path& aPath)
+	{
+		int radius = OccupancyGrid::getFreeRadius( aRobotSize);
+
+		// The walls inflated by the radius of the robot, shared by all searches with the same radius
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( radius);
+
+		// The search is bounded by the start, the goal and the inflated walls plus a border of one cell:
+		// a shortest path never has to leave that area.
+		int left = std::min( aStart.x, aGoal.x);
+		int top = std::min( aStart.y, aGoal.y);
+		int right = std::max( aStart.x, aGoal.x);
+		int bottom = std::max( aStart.y, aGoal.y);
+		if (occupancyGrid->getWidth() > 0)
+		{
+			left = std::min( left, occupancyGrid->getOrigin().x);
+			top = std::min( top, occupancyGrid->getOrigin().y);
+			right = std::max( right, occupancyGrid->getOrigin().x + occupancyGrid->getWidth() - 1);
+			bottom = std::max( bottom, occupancyGrid->getOrigin().y + occupancyGrid->getHeight() - 1);
+		}
+		if (!Path::fits( left - 1, top - 1, right + 1, bottom + 1))
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << ", the area does not fit in a Path" << std::endl;
+			outcome = NoRoute;
+			aPath.clear();
+			return false;
+		}
 		getOS().clear();
-		getCS().clear();
-		getPM().clear();
+		searchGrid.reset( Point( left - 1, top - 1), right - left + 3, bottom - top + 3);
+
+		expansionCount = 0;
+		lastProgressExpansion = 0;
+		lastProgressTime = std::chrono::steady_clock::now();
+		searchStartTime = lastProgressTime;
+		outcome = NoRoute;
+		bool progressEnabled = progressExpansionInterval != 0 || progressTimeInterval.count() != 0;
+		bool jumpPointSearch = strategy == JumpPointSearch && Connectivity::numberOfNeighbours == 8;
 
-		int radius = std::sqrt( (aRobotSize.x / 2.0) * (aRobotSize.x / 2.0) + (aRobotSize.y / 2.0) * (aRobotSize.y / 2.0));
+		// The search works on the indices of the cells, the costs are fixed point, see Cost
+		Point goal = aGoal.asPoint();
 
-		aStart.actualCost = 0.0; 													// Cost from aStart along the best known path.
-		aStart.heuristicCost = aStart.actualCost + HeuristicCost( aStart, aGoal);	// Estimated total cost from aStart to aGoal through y.
+		// The tables hold 8-connected costs, a lower bound for every strategy but LazyThetaStar
+		landmarks.reset();
+		if (useLandmarks && strategy != LazyThetaStar)
+		{
+			landmarks = Landmarks::getLandmarks( radius, aStart.asPoint(), goal);
+			if (landmarks)
+			{
+				landmarks->getDistances( goal, goalDistances);
+			}
+		}
 
-		addToOpenSet(aStart);
+		std::uint32_t goalIndex = searchGrid.indexOf( goal.x, goal.y);
+		std::uint32_t startIndex = searchGrid.indexOf( aStart.x, aStart.y);
+		SearchGrid::Cell startCell = searchGrid.at( startIndex);
+		startCell.actualCost = 0;
+		startCell.parent = SearchGrid::NoCell;
+		Cost startEstimate = Heuristic::estimate( goal.x - aStart.x, goal.y - aStart.y);
+		if (landmarks)
+		{
+			startEstimate = std::max( startEstimate, landmarks->estimate( aStart.x, aStart.y, goalDistances));
+		}
+		openSet.push( startIndex, startEstimate, 0);
 
 		//		long long begin = std::clock();
 
 		while (!openSet.empty())
 		{
-			Vertex current = *openSet.begin();
+			std::uint32_t currentIndex = openSet.top();
+			Point current = searchGrid.pointOf( currentIndex);
+			if (strategy == LazyThetaStar)
+			{
+				SetVertex( current, currentIndex, *occupancyGrid, searchGrid);
+			}
 
-			if (current.equalPoint( aGoal))
+			if (currentIndex == goalIndex)
 			{
-				return ConstructPath( predecessorMap, current);
+				ConstructPath( searchGrid, currentIndex, strategy == LazyThetaStar, aPath);
+				outcome = Found;
+				if (progressEnabled)
+				{
+					publishOpenSet();
+					notifyObservers();
+				}
+				return true;
 			} else
 			{
-				addToClosedSet( current);
-				removeFirstFromOpenSet();
-
-				const std::vector< Edge >& connections = GetNeighbourConnections( current, radius);
-				for (const Edge& connection : connections)
+				openSet.pop();
+				SearchGrid::Cell currentCell = searchGrid.at( currentIndex);
+				currentCell.state = SearchGrid::Closed;
+				notifyProgress();
+				if ((expansionCount & 0x3F) == 0 && isInterrupted())
 				{
-					Vertex neighbour = connection.otherSide( current);
-
-					// The new costs
-					double calculatedActualNeighbourCost = current.actualCost + ActualCost( current, neighbour);
-					double totalHeuristicCostNeighbour = calculatedActualNeighbourCost + HeuristicCost( neighbour, aGoal);
+					break;
+				}
 
-					OpenSet::iterator openVertex = findInOpenSet( neighbour);
-					if (openVertex != openSet.end())
+				if (jumpPointSearch)
+				{
+					Successors jumpPoints;
+					GetJumpPoints( current, currentCell.parent, goal, *occupancyGrid, searchGrid, jumpPoints);
+					for (int i = 0; i < jumpPoints.count; ++i)
 					{
-						// if neighbour is in the openSet we may have found a shorter via-route
-						if ((*openVertex).heuristicCost <= totalHeuristicCostNeighbour)
-						{
-							continue;
-						} else
-						{
-							removeFromOpenSet( openVertex);
-						}
+						const Point& jumpPoint = jumpPoints.points[i];
+						relax< Heuristic >( jumpPoint.x, jumpPoint.y, currentCell.actualCost + JumpCost( current, jumpPoint), currentIndex, goal);
 					}
-					ClosedSet::iterator closedVertex = findInClosedSet( neighbour);
-					if (closedVertex != closedSet.end())
+				} else if (strategy == LazyThetaStar && currentCell.parent != SearchGrid::NoCell)
+				{
+					// Lazy Theta* connects the neighbours to the predecessor of current, assuming it is in line of sight
+					std::uint32_t viaIndex = currentCell.parent;
+					Point via = searchGrid.pointOf( viaIndex);
+					Cost viaCost = searchGrid.getActualCost( viaIndex);
+					for (int i = 0; i < Connectivity::numberOfNeighbours; ++i)
 					{
-						// if neighbour is in the closedSet we may have found a shorter via-route
-						if ((*closedVertex).heuristicCost <= totalHeuristicCostNeighbour)
-						{
-							continue;
-						} else
+						Point neighbour( current.x + Connectivity::xOffset[i], current.y + Connectivity::yOffset[i]);
+						if (searchGrid.contains( neighbour.x, neighbour.y) && !occupancyGrid->isBlocked( neighbour.x, neighbour.y))
 						{
-							removeFromClosedSet( closedVertex);
+							relax< Heuristic >( neighbour.x, neighbour.y, viaCost + LineCost( via, neighbour), viaIndex, goal);
 						}
 					}
-
-					neighbour.actualCost = calculatedActualNeighbourCost;
-					neighbour.heuristicCost = totalHeuristicCostNeighbour;
-
-					std::pair< VertexMap::iterator, bool > insertResult1 = predecessorMap.insert( std::make_pair( neighbour, current));
-					if (insertResult1.second != true)
+				} else
+				{
+					// The neighbour offsets and step costs are constants of the policy, the loop is unrolled
+					Cost currentCost = currentCell.actualCost;
+					for (int i = 0; i < Connectivity::numberOfNeighbours; ++i)
 					{
-						if (!(*insertResult1.first).first.equalPoint( neighbour))
+						int x = current.x + Connectivity::xOffset[i];
+						int y = current.y + Connectivity::yOffset[i];
+						if (searchGrid.contains( x, y) && !occupancyGrid->isBlocked( x, y))
 						{
-							std::ostringstream os;
-							os << "*** (*insertResult1.first).first != neighbour:\n\t\t" << (*insertResult1.first).first << " <- " << (*insertResult1.first).second << "\n\t\t" << neighbour << " <- " << current;
-							throw std::runtime_error(os.str());
+							relax< Heuristic >( x, y, currentCost + Connectivity::stepCost[i], currentIndex, goal);
 						}
-
-						if ((*insertResult1.first).first.heuristicCost > neighbour.heuristicCost)
-						{
-							predecessorMap.erase( insertResult1.first);
-							std::pair< VertexMap::iterator, bool > insertResult2 = predecessorMap.insert( std::make_pair( neighbour, current));
-							if (insertResult2.second != true)
-							{
-								std::ostringstream os;
-								os << "**** Failed updating neighbour in the predecessorMap:  " << neighbour << " <- " << current << "\n";
-								if (insertResult2.first != predecessorMap.end())
-								{
-									os << "\tcurrent value in the predecessorMap:  " << (*insertResult2.first).first << " <- " << (*insertResult2.first).second;
-								} else
-								{
-									os << "\tinvalid iterator ";
-								}
-								throw std::runtime_error(os.str());
-							} else
-							{
-							}
-						}
-					} else
-					{
-					}
-
-					// if neighbour is not in openSet, add it to the openSet
-					// which should always be the case?
-					openVertex = findInOpenSet( neighbour);
-					if (openVertex == openSet.end())
-					{
-						addToOpenSet( neighbour);
-					} else
-					{
-						std::cerr << "**** Failed adding neighbour to the openSet:  " << neighbour << std::endl;
 					}
-				} //for(Edge connection : connections)
+				}
 
 				//			Improving the performance 28-04-2014.....
 				//
@@ -249,177 +708,237 @@ namespace PathAlgorithm
 				//			{
 				//				std::sort( openSet.begin(), openSet.end(), VertexLessCostCompare());
 				//			}
-				std::iter_swap(openSet.begin(), std::min_element( openSet.begin(), openSet.end(), VertexLessCostCompare()));
 			}
 		}
-		// std::cerr << "Duration: " << (std::clock() - begin) << " openSet: " << getOS().size() << " closedSet: " << getCS().size() << " predecessorMap: " << getPM().size() << std::endl;
+		// std::cerr << "Duration: " << (std::clock() - begin) << " openSet: " << getOS().size() << " closedSet: " << searchGrid.getAllocatedSize() << std::endl;
 
-		std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
-		return Path();
+		if (outcome == NoRoute)
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+		}
+		aPath.clear();
+		if (progressEnabled)
+		{
+			publishOpenSet();
+			notifyObservers();
+		}
+		return false;
 	}
 	/**
 	 *
 	 */
-	void AStar::addToOpenSet( const Vertex& aVertex)
+	/* static */void AStar::smoothPath(	const Size& aRobotSize,
+										Path& aPath)
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
-		openSet.push_back( aVertex);
-		notifyObservers();
+		if (aPath.size() < 3)
+		{
+			return;
+		}
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( OccupancyGrid::getFreeRadius( aRobotSize));
+
+		// String pulling: the last point that is in line of sight of the previous kept point is kept
+		Path smoothed;
+		smoothed.push_back( aPath.front());
+		for (std::size_t i = 1; i + 1 < aPath.size(); ++i)
+		{
+			if (!occupancyGrid->isLineFree( smoothed.back(), aPath[i + 1]))
+			{
+				smoothed.push_back( aPath[i]);
+			}
+		}
+		smoothed.push_back( aPath.back());
+		aPath.swap( smoothed);
 	}
 	/**
 	 *
 	 */
-	void AStar::removeFromOpenSet( const Vertex& aVertex)
+	template< typename Heuristic >
+	void AStar::relax(	int anX,
+						int anY,
+						Cost aCost,
+						std::uint32_t aParent,
+						const Point& aGoal)
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
-		OpenSet::iterator i = findInOpenSet( aVertex);
-		removeFromOpenSet( i);
+		std::uint32_t index = searchGrid.indexOf( anX, anY);
+		SearchGrid::Cell cell = searchGrid.at( index);
+		if (cell.state != SearchGrid::Unvisited)
+		{
+			// if the cell is in the openSet or the closedSet we may have found a shorter via-route
+			if (cell.actualCost <= aCost)
+			{
+				return;
+			}
+			if (cell.state == SearchGrid::Closed)
+			{
+				cell.state = SearchGrid::Unvisited;
+			}
+		}
+
+		// Only reached if this is the best via-route to the cell so far
+		cell.actualCost = aCost;
+		cell.parent = aParent;
+
+		Cost heuristic = Heuristic::estimate( aGoal.x - anX, aGoal.y - anY);
+		if (landmarks)
+		{
+			heuristic = std::max( heuristic, landmarks->estimate( anX, anY, goalDistances));
+		}
+		Cost estimate = aCost + heuristic;
+		if (cell.state == SearchGrid::Open)
+		{
+			openSet.update( index, estimate, aCost);
+		} else
+		{
+			openSet.push( index, estimate, aCost);
+		}
 	}
+	template bool AStar::searchWith< FourConnected, ManhattanHeuristic >( Vertex, const Vertex&, const Size&, Path&);
+	template bool AStar::searchWith< FourConnected, OctileHeuristic >( Vertex, const Vertex&, const Size&, Path&);
+	template bool AStar::searchWith< FourConnected, EuclideanHeuristic >( Vertex, const Vertex&, const Size&, Path&);
+	template bool AStar::searchWith< EightConnected, ManhattanHeuristic >( Vertex, const Vertex&, const Size&, Path&);
+	template bool AStar::searchWith< EightConnected, OctileHeuristic >( Vertex, const Vertex&, const Size&, Path&);
+	template bool AStar::searchWith< EightConnected, EuclideanHeuristic >( Vertex, const Vertex&, const Size&, Path&);
 	/**
 	 *
 	 */
-	void AStar::removeFromOpenSet( OpenSet::iterator& i)
+	void AStar::addToOpenSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
-		openSet.erase( i);
-		notifyObservers();
+		openSet.push( searchGrid.indexOf( aVertex.x, aVertex.y), static_cast< Cost >( aVertex.heuristicCost), static_cast< Cost >( aVertex.actualCost));
 	}
-	/**
-	 *
-	 */
-	OpenSet::iterator AStar::findInOpenSet( const Vertex& aVertex)
+	void AStar::removeFromOpenSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
-		return std::find_if( openSet.begin(),
-							 openSet.end(),
-							 [aVertex](const Vertex& rhs)
-							 {
-			return aVertex.equalPoint(rhs);
-							 });
+		findRemoveInOpenSet( aVertex);
 	}
 	/**
 	 *
 	 */
-	bool AStar::findRemoveInOpenSet( const Vertex& aVertex)
+	void AStar::updateInOpenSet( const Vertex& aVertex)
 	{
-		std::lock_guard< std::recursive_mutex > lock( openSetMutex);
-		OpenSet::iterator i = findInOpenSet( aVertex);
-		if (i != openSet.end())
-		{
-			openSet.erase( i);
-			return true;
-		}
-		return false;
-
+		openSet.update( searchGrid.indexOf( aVertex.x, aVertex.y), static_cast< Cost >( aVertex.heuristicCost), static_cast< Cost >( aVertex.actualCost));
 	}
 	/**
 	 *
 	 */
-	void AStar::removeFirstFromOpenSet()
+	bool AStar::isInOpenSet( const Vertex& aVertex) const
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
-		openSet.erase( openSet.begin());
+		return searchGrid.contains( aVertex.x, aVertex.y) && openSet.contains( searchGrid.indexOf( aVertex.x, aVertex.y));
 	}
 	/**
 	 *
 	 */
-	void AStar::addToClosedSet( const Vertex& aVertex)
+	bool AStar::findRemoveInOpenSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		closedSet.insert( aVertex);
-		notifyObservers();
+		return searchGrid.contains( aVertex.x, aVertex.y) && openSet.remove( searchGrid.indexOf( aVertex.x, aVertex.y));
 	}
 	/**
 	 *
 	 */
-	void AStar::removeFromClosedSet( const Vertex& aVertex)
+	void AStar::removeFirstFromOpenSet()
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		ClosedSet::iterator i = findInClosedSet( aVertex);
-		removeFromClosedSet( i);
+		openSet.pop();
 	}
 	/**
 	 *
 	 */
-	void AStar::removeFromClosedSet( ClosedSet::iterator& i)
+	void AStar::addToClosedSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		closedSet.erase( i);
-		notifyObservers();
+		searchGrid.at( searchGrid.indexOf( aVertex.x, aVertex.y)).state = SearchGrid::Closed;
 	}
 	/**
 	 *
 	 */
-	ClosedSet::iterator AStar::findInClosedSet( const Vertex& aVertex)
+	void AStar::removeFromClosedSet( const Vertex& aVertex)
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		//return std::find_if(closedSet.begin(),closedSet.end(),[aVertex](const Vertex& rhs){return aVertex.equalPoint(rhs);});
-		return closedSet.find( aVertex);
+		findRemoveClosedSet( aVertex);
 	}
 	/**
 	 *
 	 */
-	ClosedSet AStar::getClosedSet() const
+	bool AStar::isInClosedSet( const Vertex& aVertex) const
 	{
-		std::lock_guard< std::recursive_mutex > lock( closedSetMutex);
-		ClosedSet c = getCS();
-		return c;
+		return searchGrid.contains( aVertex.x, aVertex.y) && searchGrid.getState( searchGrid.indexOf( aVertex.x, aVertex.y)) == SearchGrid::Closed;
 	}
 	/**
 	 *
 	 */
 	bool AStar::findRemoveClosedSet( const Vertex& aVertex)
 	{
-		std::lock_guard< std::recursive_mutex > lock( closedSetMutex);
-		ClosedSet::iterator i = findInClosedSet( aVertex);
-		if (i != closedSet.end())
+		if (!isInClosedSet( aVertex))
 		{
-			closedSet.erase( i);
-			return true;
+			return false;
 		}
-		return false;
+		searchGrid.at( searchGrid.indexOf( aVertex.x, aVertex.y)).state = SearchGrid::Unvisited;
+		return true;
 	}
 	/**
 	 *
 	 */
-	OpenSet AStar::getOpenSet() const
+	void AStar::notifyProgress()
 	{
-		std::lock_guard< std::recursive_mutex > lock( openSetMutex);
-		OpenSet o = getOS();
-		return o;
+		++expansionCount;
+		if (progressExpansionInterval != 0 && expansionCount - lastProgressExpansion >= progressExpansionInterval)
+		{
+			lastProgressExpansion = expansionCount;
+			lastProgressTime = std::chrono::steady_clock::now();
+			publishOpenSet();
+			notifyObservers();
+		} else if (progressTimeInterval.count() != 0 && (expansionCount & 0x3F) == 0)
+		{
+			// Reading the clock is not free either, it is only read every 64 expansions
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (now - lastProgressTime >= progressTimeInterval)
+			{
+				lastProgressExpansion = expansionCount;
+				lastProgressTime = now;
+				publishOpenSet();
+				notifyObservers();
+			}
+		}
 	}
 	/**
 	 *
 	 */
-	VertexMap AStar::getPredecessorMap() const
+	bool AStar::isInterrupted()
 	{
-		std::lock_guard< std::recursive_mutex > lock( predecessorMapMutex);
-		VertexMap p = getPM();
-		return p;
+		if (cancellationFlag != nullptr && cancellationFlag->load( std::memory_order_relaxed))
+		{
+			outcome = Cancelled;
+			return true;
+		}
+		if (timeBudget.count() != 0 && std::chrono::steady_clock::now() - searchStartTime >= timeBudget)
+		{
+			outcome = OutOfTime;
+			return true;
+		}
+		return false;
 	}
-
 	/**
 	 *
 	 */
-	ClosedSet& AStar::getCS()
+	OpenSetSnapshot AStar::getOpenSet() const
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		return closedSet;
+		return std::atomic_load( &openSetSnapshot);
 	}
 	/**
 	 *
 	 */
-	const ClosedSet& AStar::getCS() const
+	void AStar::publishOpenSet()
 	{
-		std::unique_lock< std::recursive_mutex > lock( closedSetMutex);
-		return closedSet;
+		std::shared_ptr< std::vector< Vertex > > snapshot = std::make_shared< std::vector< Vertex > >();
+		snapshot->reserve( openSet.size());
+		for (std::uint32_t cell : openSet)
+		{
+			Vertex vertex( searchGrid.pointOf( cell));
+			vertex.actualCost = static_cast< double >( searchGrid.getActualCost( cell)) / StraightCost;
+			snapshot->push_back( vertex);
+		}
+		std::atomic_store( &openSetSnapshot, OpenSetSnapshot( snapshot));
 	}
 	/**
 	 *
 	 */
 	OpenSet& AStar::getOS()
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
 		return openSet;
 	}
 	/**
@@ -427,23 +946,6 @@ namespace PathAlgorithm
 	 */
 	const OpenSet& AStar::getOS() const
 	{
-		std::unique_lock< std::recursive_mutex > lock( openSetMutex);
 		return openSet;
 	}
-	/**
-	 *
-	 */
-	VertexMap& AStar::getPM()
-	{
-		std::unique_lock< std::recursive_mutex > lock( predecessorMapMutex);
-		return predecessorMap;
-	}
-	/**
-	 *
-	 */
-	const VertexMap& AStar::getPM() const
-	{
-		std::unique_lock< std::recursive_mutex > lock( predecessorMapMutex);
-		return predecessorMap;
-	}
 }// namespace PathAlgorithm
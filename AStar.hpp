@@ -3,14 +3,20 @@
 
 #include "Config.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
-#include <map>
-#include <mutex>
-#include <set>
+#include <memory>
 #include <vector>
+#include <boost/noncopyable.hpp>
 
 #include "Notifier.hpp"
+#include "Path.hpp"
 #include "Point.hpp"
+#include "SearchGrid.hpp"
 #include "Size.hpp"
 
 namespace PathAlgorithm
@@ -118,41 +124,6 @@ namespace PathAlgorithm
 			}
 	};
 	// struct VertexPointCompare
-	struct Edge
-	{
-			Edge(	const Vertex& aVertex1,
-					const Vertex& aVertex2) :
-						vertex1( aVertex1),
-						vertex2( aVertex2)
-			{
-			}
-			Edge( const Edge& anEdge) :
-				vertex1( anEdge.vertex1),
-				vertex2( anEdge.vertex2)
-			{
-			}
-
-			const Vertex& thisSide( const Vertex& aVertex) const
-			{
-				if (vertex1.equalPoint( aVertex))
-					return vertex1;
-				if (vertex2.equalPoint( aVertex))
-					return vertex2;
-				throw std::logic_error( "thisSide: huh???");
-			}
-
-			const Vertex& otherSide( const Vertex& aVertex) const
-			{
-				if (vertex1.equalPoint( aVertex))
-					return vertex2;
-				if (vertex2.equalPoint( aVertex))
-					return vertex1;
-				throw std::logic_error( "otherSide: huh???");
-			}
-
-			Vertex vertex1;
-			Vertex vertex2;
-	}; // struct Edge
 	/**
 	 *
 	 * @param os
@@ -165,29 +136,310 @@ namespace PathAlgorithm
 		return os << "(" << aVertex.x << "," << aVertex.y << "), " << aVertex.actualCost << " " << aVertex.heuristicCost;
 	}
 	/**
-	 *
-	 * @param os
-	 * @param anEdge
-	 * @return
+	 * The costs of a grid search are fixed point integers: a step to a straight neighbour costs
+	 * StraightCost, one pixel, and a step to a diagonal neighbour DiagonalCost, which is the square
+	 * root of 2 rounded up so that the heuristics below never overestimate.
 	 */
-	inline std::ostream& operator<<( 	std::ostream& os,
-										const Edge& anEdge)
+	typedef std::uint32_t Cost;
+	const Cost StraightCost = 10000;
+	const Cost DiagonalCost = 14143;
+	/**
+	 * Connectivity policy: the 4 straight neighbours of a cell
+	 */
+	struct FourConnected
 	{
-		return os << anEdge.vertex1 << " -> " << anEdge.vertex2;
-	}
-	/*
+			static const int numberOfNeighbours = 4;
+			static const int xOffset[numberOfNeighbours];
+			static const int yOffset[numberOfNeighbours];
+			static const Cost stepCost[numberOfNeighbours];
+	};
+	/**
+	 * Connectivity policy: the 8 straight and diagonal neighbours of a cell
+	 */
+	struct EightConnected
+	{
+			static const int numberOfNeighbours = 8;
+			static const int xOffset[numberOfNeighbours];
+			static const int yOffset[numberOfNeighbours];
+			static const Cost stepCost[numberOfNeighbours];
+	};
+	/**
+	 * Heuristic policy: the exact cost without walls if only the straight neighbours are connected
+	 */
+	struct ManhattanHeuristic
+	{
+			static Cost estimate(	int aDx,
+									int aDy)
+			{
+				return StraightCost * static_cast< Cost >( std::abs( aDx) + std::abs( aDy));
+			}
+	};
+	/**
+	 * Heuristic policy: the exact cost without walls if the diagonal neighbours are connected as well
+	 */
+	struct OctileHeuristic
+	{
+			static Cost estimate(	int aDx,
+									int aDy)
+			{
+				Cost dx = static_cast< Cost >( std::abs( aDx));
+				Cost dy = static_cast< Cost >( std::abs( aDy));
+				return dx < dy ? StraightCost * dy + (DiagonalCost - StraightCost) * dx : StraightCost * dx + (DiagonalCost - StraightCost) * dy;
+			}
+	};
+	/**
+	 * Heuristic policy: the straight line, the only one that does not overestimate for any-angle routes
+	 */
+	struct EuclideanHeuristic
+	{
+			static Cost estimate(	int aDx,
+									int aDy)
+			{
+				return static_cast< Cost >( std::sqrt( static_cast< double >( aDx) * aDx + static_cast< double >( aDy) * aDy) * StraightCost);
+			}
+	};
+	/**
+	 * An immutable copy of the open set, published by AStar for its readers
+	 */
+	typedef std::shared_ptr< const std::vector< Vertex > > OpenSetSnapshot;
+
+	class Landmarks;
+	typedef std::shared_ptr< const Landmarks > LandmarksPtr;
+	/**
+	 * The OpenSet is an indexed binary min-heap of cells of the SearchGrid, on the lowest estimated
+	 * total cost and then the highest actual cost. The slot of a cell in the heap is kept in the
+	 * SearchGrid so that a cell can be found in O(1) and its cost can be changed (decrease-key) in
+	 * O(log n) without a linear scan. The OpenSet also maintains the Open state of the cells.
+	 *
+	 * A heap entry is a 64 bit key, which packs both costs so that one integer compare orders two
+	 * entries, and a 32 bit cell index, kept in two separate arrays: 12 bytes per entry where a Vertex
+	 * took 24, and a sift only loads the keys it compares.
 	 *
+	 * Iterating over the OpenSet visits the cells in heap order, not in cost order.
 	 */
-	typedef std::vector< Vertex > Path;
-	typedef std::vector< Vertex > OpenSet;
-	typedef std::set< Vertex, VertexLessIdCompare > ClosedSet;
-	typedef std::map< Vertex, Vertex, VertexLessIdCompare > VertexMap;
+	class OpenSet : private boost::noncopyable
+	{
+		public:
+			typedef std::vector< std::uint32_t >::const_iterator const_iterator;
+			/**
+			 * All cells must be in the area of aSearchGrid
+			 */
+			explicit OpenSet( SearchGrid& aSearchGrid) :
+				searchGrid( aSearchGrid)
+			{
+			}
+			/**
+			 *
+			 */
+			bool empty() const
+			{
+				return cells.empty();
+			}
+			/**
+			 *
+			 */
+			std::size_t size() const
+			{
+				return cells.size();
+			}
+			/**
+			 *
+			 */
+			const_iterator begin() const
+			{
+				return cells.begin();
+			}
+			/**
+			 *
+			 */
+			const_iterator end() const
+			{
+				return cells.end();
+			}
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 * @return The cell with the lowest cost
+			 */
+			std::uint32_t top() const
+			{
+				return cells.front();
+			}
+			/**
+			 * @return The estimated total cost of the cell with the lowest cost
+			 */
+			Cost getTopEstimate() const
+			{
+				return static_cast< Cost >( keys.front() >> 32);
+			}
+			/**
+			 * Removes the cell with the lowest cost, O(log n)
+			 */
+			void pop();
+			/**
+			 * Adds a cell that is not yet in the OpenSet, O(log n)
+			 *
+			 * @param anEstimate The estimated total cost of a route through aCell
+			 * @param anActualCost The cost of the route to aCell, the higher one is first if the estimates are equal
+			 */
+			void push(	std::uint32_t aCell,
+						Cost anEstimate,
+						Cost anActualCost);
+			/**
+			 * Replaces the costs of a cell in the OpenSet and restores the heap order, O(log n)
+			 */
+			void update(	std::uint32_t aCell,
+							Cost anEstimate,
+							Cost anActualCost);
+			/**
+			 * Removes aCell if it is in the OpenSet, O(log n)
+			 *
+			 * @return true if the cell was found and removed
+			 */
+			bool remove( std::uint32_t aCell);
+			/**
+			 * @return true if aCell is in the OpenSet, O(1)
+			 */
+			bool contains( std::uint32_t aCell) const
+			{
+				return searchGrid.getState( aCell) == SearchGrid::Open;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			static std::uint64_t makeKey(	Cost anEstimate,
+											Cost anActualCost)
+			{
+				return static_cast< std::uint64_t >( anEstimate) << 32 | (0xFFFFFFFFu - anActualCost);
+			}
+			/**
+			 *
+			 */
+			void siftUp( std::size_t aSlot);
+			/**
+			 *
+			 */
+			void siftDown( std::size_t aSlot);
+			/**
+			 *
+			 */
+			void place( 	std::size_t aSlot,
+							std::uint64_t aKey,
+							std::uint32_t aCell);
+			/**
+			 *
+			 */
+			void removeAt( std::size_t aSlot);
+
+			SearchGrid& searchGrid;
+			std::vector< std::uint64_t > keys;
+			std::vector< std::uint32_t > cells;
+	}; // class OpenSet
 	/**
 	 *
 	 */
 	class AStar : public Base::Notifier
 	{
 		public:
+			/**
+			 * The way the neighbours of an expanded Vertex are generated
+			 */
+			enum Strategy
+			{
+				/**
+				 * All 8 neighbours of every expanded cell
+				 */
+				Standard,
+				/**
+				 * Jump Point Search: the neighbours are pruned on the direction of travel and every
+				 * direction is followed to the next jump point, so only a few cells are expanded on an
+				 * open, uniform cost grid. The route has the same cost and is returned cell by cell.
+				 */
+				JumpPointSearch,
+				/**
+				 * Lazy Theta*: the predecessor of a cell may be any cell that is in line of sight, not
+				 * only a neighbour, so the route is a few straight segments in any direction. The route
+				 * is returned as the end points of the segments only.
+				 */
+				LazyThetaStar
+			};
+			/**
+			 * How the last search ended
+			 */
+			enum Outcome
+			{
+				Found,
+				NoRoute,
+				/**
+				 * The cancellation flag was set during the search
+				 */
+				Cancelled,
+				/**
+				 * The time budget ran out before the goal was reached
+				 */
+				OutOfTime
+			};
+			/**
+			 *
+			 */
+			AStar();
+			/**
+			 *
+			 */
+			Strategy getStrategy() const
+			{
+				return strategy;
+			}
+			/**
+			 *
+			 */
+			void setStrategy( Strategy aStrategy);
+			/**
+			 * Publishes the progress of a search to the observers every anExpansionInterval expanded
+			 * vertices or every aTimeInterval, whichever comes first, and once more when the search ends.
+			 * An interval of 0 disables that trigger. Both are 0 by default: the observers are not
+			 * notified at all, a search without a viewer does not pay for notifications.
+			 */
+			void setProgressInterval(	unsigned long anExpansionInterval,
+										std::chrono::milliseconds aTimeInterval);
+			/**
+			 * A search stops without a route if aFlag becomes true. The flag is polled every 64
+			 * expansions, so setting it from another thread stops the search within microseconds.
+			 *
+			 * @param aFlag The flag, nullptr (the default) if a search can not be cancelled
+			 */
+			void setCancellationFlag( const std::atomic< bool >* aFlag);
+			/**
+			 * A search stops without a route if it takes longer than aTimeBudget, 0 (the default)
+			 * is no limit
+			 */
+			void setTimeBudget( std::chrono::milliseconds aTimeBudget);
+			/**
+			 * A search with the Standard or JumpPointSearch strategy takes the largest of its own
+			 * heuristic and the ALT bound of the Landmarks of the radius of the robot, if their tables
+			 * are built for the current walls. Off by default. The ALT bound is not a lower bound on
+			 * an any-angle route and is not used by LazyThetaStar.
+			 */
+			void setUseLandmarks( bool aUseLandmarks);
+			/**
+			 *
+			 */
+			Outcome getOutcome() const
+			{
+				return outcome;
+			}
+			/**
+			 *
+			 * @return The number of vertices expanded by the current or last search
+			 */
+			unsigned long getExpansionCount() const
+			{
+				return expansionCount;
+			}
 			/**
 			 *
 			 */
@@ -200,6 +452,42 @@ namespace PathAlgorithm
 			Path search(Vertex aStart,
 						const Vertex& aGoal,
 						const Size& aRobotSize);
+			/**
+			 * Searches a route and writes it into aPath, reusing the capacity aPath already has
+			 *
+			 * @return true if a route was found, false if not in which case aPath is empty
+			 */
+			bool search(const Point& aStartPoint,
+						const Point& aGoalPoint,
+						const Size& aRobotSize,
+						Path& aPath);
+			/**
+			 * Searches a route and writes it into aPath, reusing the capacity aPath already has. The
+			 * grid is 8-connected with the octile heuristic, or the Euclidean heuristic for LazyThetaStar.
+			 *
+			 * @return true if a route was found, false if not in which case aPath is empty
+			 */
+			bool search(Vertex aStart,
+						const Vertex& aGoal,
+						const Size& aRobotSize,
+						Path& aPath);
+			/**
+			 * search with the connectivity and the heuristic as compile time policies: FourConnected or
+			 * EightConnected and ManhattanHeuristic, OctileHeuristic or EuclideanHeuristic. All six
+			 * combinations are instantiated. JumpPointSearch needs EightConnected, with FourConnected
+			 * the Standard strategy is used.
+			 */
+			template< typename Connectivity, typename Heuristic >
+			bool searchWith(	Vertex aStart,
+								const Vertex& aGoal,
+								const Size& aRobotSize,
+								Path& aPath);
+			/**
+			 * Reduces aPath to the points where it changes direction around a wall: every point that
+			 * is in line of sight of the previous remaining point and the next one is removed.
+			 */
+			static void smoothPath(	const Size& aRobotSize,
+									Path& aPath);
 			/**
 			 *
 			 */
@@ -209,13 +497,14 @@ namespace PathAlgorithm
 			 */
 			void removeFromOpenSet( const Vertex& aVertex);
 			/**
-			 *
+			 * Changes the costs of a Vertex that is already in the openSet
 			 */
-			void removeFromOpenSet( OpenSet::iterator& i);
+			void updateInOpenSet( const Vertex& aVertex);
 			/**
 			 *
+			 * @return true if the cell of aVertex is in the openSet
 			 */
-			OpenSet::iterator findInOpenSet( const Vertex& aVertex);
+			bool isInOpenSet( const Vertex& aVertex) const;
 			/**
 			 *
 			 */
@@ -235,71 +524,87 @@ namespace PathAlgorithm
 			/**
 			 *
 			 */
-			void removeFromClosedSet( ClosedSet::iterator& i);
-			/**
-			 *
-			 */
-			ClosedSet::iterator findInClosedSet( const Vertex& aVertex);
+			bool isInClosedSet( const Vertex& aVertex) const;
 			/**
 			 *
 			 */
 			bool findRemoveClosedSet( const Vertex& aVertex);
 			/**
+			 * The state of a search is owned by the thread that runs the search and is not locked.
+			 * Other threads, like the view, read the snapshot of the openSet that is published with
+			 * every progress notification, see setProgressInterval.
 			 *
+			 * @return The vertices of the openSet at the last progress notification, in heap order,
+			 * 		   nullptr if no progress has been published yet
 			 */
-			ClosedSet getClosedSet() const;
+			OpenSetSnapshot getOpenSet() const;
+
+		protected:
 			/**
 			 *
 			 */
-			OpenSet getOpenSet() const;
+			OpenSet& getOS();
 			/**
 			 *
 			 */
-			VertexMap getPredecessorMap() const;
+			const OpenSet& getOS() const;
 
-		protected:
+		private:
 			/**
-			 *
+			 * Gives the cell at (anX,anY) the cost aCost and the predecessor aParent and opens it, if
+			 * aCost is lower than the cost it has
 			 */
-			ClosedSet& getCS();
+			template< typename Heuristic >
+			void relax(	int anX,
+						int anY,
+						Cost aCost,
+						std::uint32_t aParent,
+						const Point& aGoal);
 			/**
-			 *
+			 * Called once per expanded vertex, notifies the observers if a progress interval passed
 			 */
-			const ClosedSet& getCS() const;
+			void notifyProgress();
 			/**
-			 *
+			 * Replaces the snapshot of the openSet, readers keep the snapshot they already have
 			 */
-			OpenSet& getOS();
+			void publishOpenSet();
 			/**
 			 *
+			 * @return true if the search must stop because it is cancelled or out of time
 			 */
-			const OpenSet& getOS() const;
+			bool isInterrupted();
 			/**
 			 *
 			 */
-			VertexMap& getPM();
+			Strategy strategy;
+			unsigned long progressExpansionInterval;
+			std::chrono::milliseconds progressTimeInterval;
+			unsigned long expansionCount;
+			unsigned long lastProgressExpansion;
+			std::chrono::steady_clock::time_point lastProgressTime;
+			const std::atomic< bool >* cancellationFlag;
+			std::chrono::milliseconds timeBudget;
+			std::chrono::steady_clock::time_point searchStartTime;
+			Outcome outcome;
+			bool useLandmarks;
 			/**
-			 *
+			 * The Landmarks of the current search, nullptr if it has none, and the costs from its goal
+			 * to every landmark
 			 */
-			const VertexMap& getPM() const;
-
-		private:
+			LandmarksPtr landmarks;
+			std::vector< Cost > goalDistances;
 			/**
-			 *
+			 * The cost, predecessor and open/closed state of all cells, reused by every search
 			 */
-			ClosedSet closedSet;
+			SearchGrid searchGrid;
 			/**
 			 *
 			 */
 			OpenSet openSet;
 			/**
-			 *
+			 * Only accessed with std::atomic_load and std::atomic_store
 			 */
-			VertexMap predecessorMap;
-
-			mutable std::recursive_mutex openSetMutex;
-			mutable std::recursive_mutex closedSetMutex;
-			mutable std::recursive_mutex predecessorMapMutex;
+			OpenSetSnapshot openSetSnapshot;
 
 	}; // class AStar
 } // namespace PathAlgorithm
@@ -0,0 +1,34 @@
+#include "AbstractBenchmark.hpp"
+#include <sstream>
+
+namespace Application
+{
+	/**
+	 *
+	 */
+	AbstractBenchmark::AbstractBenchmark(	const std::string& aName,
+											const std::vector< int >& aSizes) :
+												name( aName),
+												sizes( aSizes)
+	{
+	}
+	/**
+	 *
+	 */
+	AbstractBenchmark::~AbstractBenchmark()
+	{
+	}
+	/**
+	 *
+	 */
+	void AbstractBenchmark::run( std::ostream& anOutput)
+	{
+		for (int size : sizes)
+		{
+			std::mt19937 random( 42);
+			std::ostringstream log;
+			runSize( size, random, log);
+			anOutput << name << ": " << log.str() << std::endl;
+		}
+	}
+} // namespace Application
@@ -0,0 +1,57 @@
+#ifndef ABSTRACTBENCHMARK_HPP_
+#define ABSTRACTBENCHMARK_HPP_
+
+#include "Config.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Application
+{
+	/**
+	 * A benchmark of the benchmark program. It runs once for every size, each time with a random
+	 * generator seeded with 42 so that every run measures the same input, and writes a line with its
+	 * name and the results per size.
+	 */
+	class AbstractBenchmark
+	{
+		public:
+			/**
+			 *
+			 */
+			AbstractBenchmark(	const std::string& aName,
+								const std::vector< int >& aSizes);
+			/**
+			 *
+			 */
+			virtual ~AbstractBenchmark();
+			/**
+			 *
+			 */
+			const std::string& getName() const
+			{
+				return name;
+			}
+			/**
+			 * Runs the benchmark for every size and writes the results to anOutput
+			 */
+			void run( std::ostream& anOutput);
+
+		protected:
+			/**
+			 * Runs the benchmark for aSize and writes the results to aLog on a single line, without the
+			 * end of the line
+			 */
+			virtual void runSize(	int aSize,
+									std::mt19937& aRandom,
+									std::ostream& aLog) = 0;
+
+		private:
+			std::string name;
+			std::vector< int > sizes;
+	};
+	//	class AbstractBenchmark
+} // namespace Application
+#endif // ABSTRACTBENCHMARK_HPP_
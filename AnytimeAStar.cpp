@@ -0,0 +1,301 @@
+#include "AnytimeAStar.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	AnytimeAStar::AnytimeAStar() :
+								initialWeight( 3.0),
+								weightDecrement( 0.5),
+								weight( 1.0),
+								bound( 1.0),
+								cancellationFlag( nullptr),
+								timeBudget( 0),
+								outcome( AStar::NoRoute),
+								expansionCount( 0),
+								iterationCount( 0),
+								goal( 0, 0),
+								pathCost( 0),
+								openSet( searchGrid)
+	{
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::setWeights(	double anInitialWeight,
+									double aWeightDecrement)
+	{
+		initialWeight = std::max( 1.0, anInitialWeight);
+		weightDecrement = aWeightDecrement;
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::setCancellationFlag( const std::atomic< bool >* aFlag)
+	{
+		cancellationFlag = aFlag;
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::setTimeBudget( std::chrono::milliseconds aTimeBudget)
+	{
+		timeBudget = aTimeBudget;
+	}
+	/**
+	 *
+	 */
+	bool AnytimeAStar::search(	const Point& aStartPoint,
+								const Point& aGoalPoint,
+								const Size& aRobotSize,
+								Path& aPath)
+	{
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( OccupancyGrid::getFreeRadius( aRobotSize));
+
+		// The area of the search as in AStar
+		int left = std::min( aStartPoint.x, aGoalPoint.x);
+		int top = std::min( aStartPoint.y, aGoalPoint.y);
+		int right = std::max( aStartPoint.x, aGoalPoint.x);
+		int bottom = std::max( aStartPoint.y, aGoalPoint.y);
+		if (occupancyGrid->getWidth() > 0)
+		{
+			left = std::min( left, occupancyGrid->getOrigin().x);
+			top = std::min( top, occupancyGrid->getOrigin().y);
+			right = std::max( right, occupancyGrid->getOrigin().x + occupancyGrid->getWidth() - 1);
+			bottom = std::max( bottom, occupancyGrid->getOrigin().y + occupancyGrid->getHeight() - 1);
+		}
+		if (!Path::fits( left - 1, top - 1, right + 1, bottom + 1))
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << ", the area does not fit in a Path" << std::endl;
+			outcome = AStar::NoRoute;
+			aPath.clear();
+			return false;
+		}
+		openSet.clear();
+		searchGrid.reset( Point( left - 1, top - 1), right - left + 3, bottom - top + 3);
+		closed.clear();
+		inconsistent.clear();
+		path.clear();
+
+		goal = aGoalPoint;
+		weight = initialWeight;
+		bound = std::numeric_limits< double >::infinity();
+		outcome = AStar::NoRoute;
+		expansionCount = 0;
+		iterationCount = 0;
+		searchStartTime = std::chrono::steady_clock::now();
+
+		std::uint32_t startIndex = searchGrid.indexOf( aStartPoint.x, aStartPoint.y);
+		SearchGrid::Cell startCell = searchGrid.at( startIndex);
+		startCell.actualCost = 0;
+		startCell.parent = SearchGrid::NoCell;
+		openSet.push( startIndex, estimate( startIndex), 0);
+
+		std::uint32_t goalIndex = searchGrid.indexOf( goal.x, goal.y);
+		for (;;)
+		{
+			if (!improvePath( *occupancyGrid))
+			{
+				break;
+			}
+			if (searchGrid.getState( goalIndex) == SearchGrid::Unvisited)
+			{
+				// Nothing is open any more and the goal was not reached
+				break;
+			}
+
+			Cost goalCost = searchGrid.getActualCost( goalIndex);
+			if (path.empty() || goalCost < pathCost)
+			{
+				++iterationCount;
+				constructPath( goalIndex);
+			}
+			double lowestCost = getLowestCost();
+			bound = lowestCost > 0.0 ? std::min( weight, goalCost / lowestCost) : weight;
+			bound = std::max( 1.0, bound);
+			if (weight <= 1.0 || bound <= 1.0)
+			{
+				bound = 1.0;
+			}
+			notifyObservers();
+			if (bound <= 1.0)
+			{
+				break;
+			}
+
+			// The route is often better than the weight guarantees: a weight above the bound that was
+			// achieved would not improve it
+			weight = std::max( 1.0, std::min( weight - weightDecrement, bound));
+			reopen();
+		}
+
+		if (outcome == AStar::Cancelled)
+		{
+			path.clear();
+		} else if (!path.empty())
+		{
+			// Also if the time ran out, the route is the best one found within the budget
+			outcome = AStar::Found;
+		} else if (outcome == AStar::NoRoute)
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << std::endl;
+		}
+		aPath = path;
+		return !path.empty();
+	}
+	/**
+	 *
+	 */
+	bool AnytimeAStar::improvePath( const OccupancyGrid& anOccupancyGrid)
+	{
+		std::uint32_t goalIndex = searchGrid.indexOf( goal.x, goal.y);
+		while (!openSet.empty())
+		{
+			if (searchGrid.getState( goalIndex) != SearchGrid::Unvisited && searchGrid.getActualCost( goalIndex) <= openSet.getTopEstimate())
+			{
+				return true;
+			}
+
+			std::uint32_t currentIndex = openSet.top();
+			openSet.pop();
+			Point current = searchGrid.pointOf( currentIndex);
+			SearchGrid::Cell currentCell = searchGrid.at( currentIndex);
+			currentCell.state = SearchGrid::Closed;
+			closed.push_back( currentIndex);
+
+			++expansionCount;
+			if ((expansionCount & 0x3F) == 0 && isInterrupted())
+			{
+				return false;
+			}
+
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				int x = current.x + EightConnected::xOffset[i];
+				int y = current.y + EightConnected::yOffset[i];
+				if (!searchGrid.contains( x, y) || anOccupancyGrid.isBlocked( x, y))
+				{
+					continue;
+				}
+				Cost cost = currentCell.actualCost + EightConnected::stepCost[i];
+				std::uint32_t neighbourIndex = searchGrid.indexOf( x, y);
+				SearchGrid::Cell neighbourCell = searchGrid.at( neighbourIndex);
+				if (neighbourCell.state != SearchGrid::Unvisited && neighbourCell.actualCost <= cost)
+				{
+					continue;
+				}
+				neighbourCell.actualCost = cost;
+				neighbourCell.parent = currentIndex;
+
+				if (neighbourCell.state == SearchGrid::Open)
+				{
+					openSet.update( neighbourIndex, estimate( neighbourIndex), cost);
+				} else if (neighbourCell.state == SearchGrid::Closed)
+				{
+					// A cell is expanded only once per iteration
+					inconsistent.push_back( neighbourIndex);
+				} else
+				{
+					openSet.push( neighbourIndex, estimate( neighbourIndex), cost);
+				}
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::reopen()
+	{
+		std::vector< std::uint32_t > open( openSet.begin(), openSet.end());
+		openSet.clear();
+
+		for (std::uint32_t index : closed)
+		{
+			searchGrid.at( index).state = SearchGrid::Reached;
+		}
+		closed.clear();
+		for (std::uint32_t index : inconsistent)
+		{
+			if (searchGrid.getState( index) == SearchGrid::Reached)
+			{
+				searchGrid.at( index).state = SearchGrid::Unvisited;
+				open.push_back( index);
+			}
+		}
+		inconsistent.clear();
+
+		for (std::uint32_t index : open)
+		{
+			openSet.push( index, estimate( index), searchGrid.getActualCost( index));
+		}
+	}
+	/**
+	 *
+	 */
+	double AnytimeAStar::getLowestCost()
+	{
+		double lowestCost = std::numeric_limits< double >::infinity();
+		for (std::uint32_t index : openSet)
+		{
+			Point point = searchGrid.pointOf( index);
+			lowestCost = std::min( lowestCost, searchGrid.getActualCost( index) + heuristicCost( point.x, point.y));
+		}
+		for (std::uint32_t index : inconsistent)
+		{
+			Point point = searchGrid.pointOf( index);
+			lowestCost = std::min( lowestCost, searchGrid.getActualCost( index) + heuristicCost( point.x, point.y));
+		}
+		return lowestCost;
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::constructPath( std::uint32_t aGoalIndex)
+	{
+		path.clear();
+		for (std::uint32_t node = aGoalIndex; node != SearchGrid::NoCell; node = searchGrid.getParent( node))
+		{
+			path.push_back( searchGrid.pointOf( node));
+		}
+		path.reverse();
+		pathCost = searchGrid.getActualCost( aGoalIndex);
+	}
+	/**
+	 *
+	 */
+	Cost AnytimeAStar::estimate( std::uint32_t anIndex) const
+	{
+		Point point = searchGrid.pointOf( anIndex);
+		return searchGrid.getActualCost( anIndex) + static_cast< Cost >( weight * heuristicCost( point.x, point.y));
+	}
+	/**
+	 *
+	 */
+	double AnytimeAStar::heuristicCost(	int anX,
+										int anY) const
+	{
+		return OctileHeuristic::estimate( goal.x - anX, goal.y - anY);
+	}
+	/**
+	 *
+	 */
+	bool AnytimeAStar::isInterrupted()
+	{
+		if (cancellationFlag != nullptr && cancellationFlag->load( std::memory_order_relaxed))
+		{
+			outcome = AStar::Cancelled;
+			return true;
+		}
+		if (timeBudget.count() != 0 && std::chrono::steady_clock::now() - searchStartTime >= timeBudget)
+		{
+			outcome = AStar::OutOfTime;
+			return true;
+		}
+		return false;
+	}
+} // namespace PathAlgorithm
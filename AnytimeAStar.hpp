@@ -0,0 +1,168 @@
+#ifndef ANYTIMEASTAR_HPP_
+#define ANYTIMEASTAR_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "AStar.hpp"
+#include "Notifier.hpp"
+#include "OccupancyGrid.hpp"
+#include "Point.hpp"
+#include "SearchGrid.hpp"
+#include "Size.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * AnytimeAStar is Anytime Repairing A* (ARA*, Likhachev, Gordon and Thrun) on the OccupancyGrid
+	 * with the neighbours of AStar. It first searches with the heuristic inflated by a weight, which
+	 * finds a route quickly whose cost is at most weight times the optimal cost. It then lowers the
+	 * weight and repairs that route, reusing the costs found so far, until the weight is 1 and the
+	 * route is optimal or until the time budget runs out.
+	 *
+	 * The observers are notified every time a better route is found, getPath and getBound are valid
+	 * during the notification.
+	 */
+	class AnytimeAStar :	public Base::Notifier,
+							private boost::noncopyable
+	{
+		public:
+			/**
+			 *
+			 */
+			AnytimeAStar();
+			/**
+			 *
+			 * @param anInitialWeight The weight of the heuristic for the first route, at least 1
+			 * @param aWeightDecrement The weight is lowered by this after every route, down to 1
+			 */
+			void setWeights(	double anInitialWeight,
+								double aWeightDecrement);
+			/**
+			 * As AStar::setCancellationFlag
+			 */
+			void setCancellationFlag( const std::atomic< bool >* aFlag);
+			/**
+			 * The search returns the best route found within aTimeBudget, 0 (the default) is no limit
+			 */
+			void setTimeBudget( std::chrono::milliseconds aTimeBudget);
+			/**
+			 *
+			 * @param aPath Receives the best route found
+			 * @return true if a route was found, even if the search was stopped before it was optimal
+			 */
+			bool search(	const Point& aStartPoint,
+							const Point& aGoalPoint,
+							const Size& aRobotSize,
+							Path& aPath);
+			/**
+			 * Found if a route was found, otherwise why not
+			 */
+			AStar::Outcome getOutcome() const
+			{
+				return outcome;
+			}
+			/**
+			 *
+			 * @return The cost of the route is at most this times the optimal cost, 1 if it is optimal
+			 */
+			double getBound() const
+			{
+				return bound;
+			}
+			/**
+			 *
+			 * @return The best route so far
+			 */
+			const Path& getPath() const
+			{
+				return path;
+			}
+			/**
+			 *
+			 * @return The number of cells expanded by the last search, in all iterations
+			 */
+			unsigned long getExpansionCount() const
+			{
+				return expansionCount;
+			}
+			/**
+			 *
+			 * @return The number of routes found by the last search
+			 */
+			unsigned long getIterationCount() const
+			{
+				return iterationCount;
+			}
+
+		private:
+			/**
+			 * Expands cells until no open cell can improve the route to the goal for the current weight
+			 *
+			 * @return false if the search was interrupted
+			 */
+			bool improvePath( const OccupancyGrid& anOccupancyGrid);
+			/**
+			 * Starts the next iteration: the cells that became inconsistent are opened again, the
+			 * closed cells become reached and the open cells are sorted for the new weight
+			 */
+			void reopen();
+			/**
+			 *
+			 * @return The lowest cost without weight (cost plus heuristic) of all open and inconsistent cells
+			 */
+			double getLowestCost();
+			/**
+			 *
+			 */
+			void constructPath( std::uint32_t aGoalIndex);
+			/**
+			 *
+			 * @return The cost plus the weighted heuristic of the cell, the key of the cell in the openSet
+			 */
+			Cost estimate( std::uint32_t anIndex) const;
+			/**
+			 * The octile distance to the goal, fixed point as the costs of the cells
+			 */
+			double heuristicCost(	int anX,
+									int anY) const;
+			/**
+			 *
+			 */
+			bool isInterrupted();
+
+			double initialWeight;
+			double weightDecrement;
+			double weight;
+			double bound;
+			const std::atomic< bool >* cancellationFlag;
+			std::chrono::milliseconds timeBudget;
+			std::chrono::steady_clock::time_point searchStartTime;
+			AStar::Outcome outcome;
+			unsigned long expansionCount;
+			unsigned long iterationCount;
+
+			Point goal;
+			Path path;
+			/**
+			 * The cost of path, fixed point as the costs of the cells
+			 */
+			Cost pathCost;
+			SearchGrid searchGrid;
+			OpenSet openSet;
+			/**
+			 * The cells closed in the current iteration
+			 */
+			std::vector< std::uint32_t > closed;
+			/**
+			 * The closed cells whose cost was lowered in the current iteration, they are opened in the next
+			 */
+			std::vector< std::uint32_t > inconsistent;
+	}; // class AnytimeAStar
+} // namespace PathAlgorithm
+#endif // ANYTIMEASTAR_HPP_
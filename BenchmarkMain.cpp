@@ -0,0 +1,48 @@
+#include "Config.hpp"
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "BroadphaseBenchmark.hpp"
+#include "FleetBenchmark.hpp"
+#include "IntersectionBenchmark.hpp"
+
+/**
+ * The benchmark program runs the benchmarks that are named on the command line, or all of them,
+ * outside of the GUI: "benchmark fleet intersection broadphase"
+ */
+int main( 	int argc,
+			char* argv[])
+{
+	try
+	{
+		std::vector< std::shared_ptr< Application::AbstractBenchmark > > benchmarks;
+		benchmarks.push_back( std::make_shared< Application::FleetBenchmark >());
+		benchmarks.push_back( std::make_shared< Application::IntersectionBenchmark >());
+		benchmarks.push_back( std::make_shared< Application::BroadphaseBenchmark >());
+
+		for (std::shared_ptr< Application::AbstractBenchmark > benchmark : benchmarks)
+		{
+			bool selected = argc == 1;
+			for (int i = 1; i < argc; ++i)
+			{
+				selected = selected || benchmark->getName() == argv[i];
+			}
+			if (selected)
+			{
+				benchmark->run( std::cout);
+			}
+		}
+		return 0;
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+	}
+	catch (...)
+	{
+		std::cerr << __PRETTY_FUNCTION__ << ": unknown exception" << std::endl;
+	}
+	return 1;
+}
@@ -0,0 +1,142 @@
+#include "Broadphase.hpp"
+#include <algorithm>
+
+namespace Model
+{
+	/**
+	 *
+	 */
+	Broadphase::Broadphase() :
+								sorted( true),
+								maximumWidth( 0.0)
+	{
+	}
+	/**
+	 *
+	 */
+	std::size_t Broadphase::add( const Pose& aPose)
+	{
+		std::size_t handle;
+		if (freeHandles.empty())
+		{
+			handle = entries.size();
+			entries.push_back( Entry());
+		} else
+		{
+			handle = freeHandles.back();
+			freeHandles.pop_back();
+		}
+		setPose( entries[handle], aPose);
+		order.push_back( handle);
+		sorted = false;
+		return handle;
+	}
+	/**
+	 *
+	 */
+	void Broadphase::update(	std::size_t aHandle,
+								const Pose& aPose)
+	{
+		setPose( entries[aHandle], aPose);
+		sorted = false;
+	}
+	/**
+	 *
+	 */
+	void Broadphase::remove( std::size_t aHandle)
+	{
+		std::vector< std::size_t >::iterator i = std::find( order.begin(), order.end(), aHandle);
+		if (i != order.end())
+		{
+			order.erase( i);
+			freeHandles.push_back( aHandle);
+		}
+	}
+	/**
+	 *
+	 */
+	void Broadphase::clear()
+	{
+		entries.clear();
+		order.clear();
+		freeHandles.clear();
+		sorted = true;
+		maximumWidth = 0.0;
+	}
+	/**
+	 *
+	 */
+	void Broadphase::findPairs( std::vector< std::pair< std::size_t, std::size_t > >& aPairs)
+	{
+		sort();
+		for (std::size_t i = 0; i < order.size(); ++i)
+		{
+			const Entry& entry = entries[order[i]];
+			for (std::size_t j = i + 1; j < order.size() && entries[order[j]].left <= entry.right; ++j)
+			{
+				const Entry& other = entries[order[j]];
+				if (other.top <= entry.bottom && entry.top <= other.bottom && entry.pose.intersects( other.pose))
+				{
+					aPairs.push_back( std::make_pair( std::min( order[i], order[j]), std::max( order[i], order[j])));
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void Broadphase::findOverlaps(	std::size_t aHandle,
+									std::vector< std::size_t >& aHandles)
+	{
+		sort();
+		const Entry& entry = entries[aHandle];
+
+		// No box that starts more than the widest box to the left can reach this one
+		std::vector< std::size_t >::iterator first = std::lower_bound( order.begin(), order.end(), entry.left - maximumWidth, [this]( std::size_t anOther, double aLeft)
+																		{
+																			return entries[anOther].left < aLeft;
+																		});
+		for (std::vector< std::size_t >::iterator i = first; i != order.end() && entries[*i].left <= entry.right; ++i)
+		{
+			const Entry& other = entries[*i];
+			if (*i != aHandle && other.right >= entry.left && other.top <= entry.bottom && entry.top <= other.bottom && entry.pose.intersects( other.pose))
+			{
+				aHandles.push_back( *i);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void Broadphase::setPose(	Entry& anEntry,
+								const Pose& aPose)
+	{
+		anEntry.pose = aPose;
+		aPose.getBounds( anEntry.left, anEntry.top, anEntry.right, anEntry.bottom);
+	}
+	/**
+	 *
+	 */
+	void Broadphase::sort()
+	{
+		if (sorted)
+		{
+			return;
+		}
+		maximumWidth = 0.0;
+		for (std::size_t i = 0; i < order.size(); ++i)
+		{
+			std::size_t handle = order[i];
+			double left = entries[handle].left;
+			maximumWidth = std::max( maximumWidth, entries[handle].right - left);
+
+			std::size_t j = i;
+			for (; j > 0 && entries[order[j - 1]].left > left; --j)
+			{
+				order[j] = order[j - 1];
+			}
+			order[j] = handle;
+		}
+		sorted = true;
+	}
+} // namespace Model
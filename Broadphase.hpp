@@ -0,0 +1,104 @@
+#ifndef BROADPHASE_HPP_
+#define BROADPHASE_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "Pose.hpp"
+
+namespace Model
+{
+	/**
+	 * The Broadphase finds the boxes that overlap among many moving boxes, the robots of a fleet,
+	 * without testing every pair. It sorts the boxes on the left side of their bounds and sweeps over
+	 * them: only boxes whose bounds overlap on x, and then on y, get the exact test of Pose.
+	 *
+	 * The boxes move a little between two queries, so the order of the previous query is almost
+	 * right and an insertion sort restores it in about linear time. A query sorts only if a box moved.
+	 *
+	 * The Broadphase does not lock, RobotWorld serialises the changes and the queries.
+	 */
+	class Broadphase : private boost::noncopyable
+	{
+		public:
+			/**
+			 *
+			 */
+			Broadphase();
+			/**
+			 *
+			 * @return The handle of the box, the handles of removed boxes are used again
+			 */
+			std::size_t add( const Pose& aPose);
+			/**
+			 * Moves the box of aHandle to aPose
+			 */
+			void update(	std::size_t aHandle,
+							const Pose& aPose);
+			/**
+			 *
+			 */
+			void remove( std::size_t aHandle);
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 * Appends every pair of handles of boxes that overlap to aPairs, the smaller handle first
+			 */
+			void findPairs( std::vector< std::pair< std::size_t, std::size_t > >& aPairs);
+			/**
+			 * Appends the handles of the other boxes that overlap the box of aHandle to aHandles
+			 */
+			void findOverlaps(	std::size_t aHandle,
+								std::vector< std::size_t >& aHandles);
+			/**
+			 *
+			 * @return The number of boxes
+			 */
+			std::size_t size() const
+			{
+				return order.size();
+			}
+
+		private:
+			/**
+			 *
+			 */
+			struct Entry
+			{
+					Pose pose;
+					double left;
+					double top;
+					double right;
+					double bottom;
+			};
+			/**
+			 *
+			 */
+			void setPose(	Entry& anEntry,
+							const Pose& aPose);
+			/**
+			 * Restores the order of the boxes on their left side after they moved
+			 */
+			void sort();
+
+			std::vector< Entry > entries;
+			/**
+			 * The handles of the boxes, on the left side of their bounds after sort
+			 */
+			std::vector< std::size_t > order;
+			std::vector< std::size_t > freeHandles;
+			bool sorted;
+			/**
+			 * The widest bounds since the last sort, a query for a single box starts this far to its left
+			 */
+			double maximumWidth;
+	};
+	//	class Broadphase
+} // namespace Model
+#endif // BROADPHASE_HPP_
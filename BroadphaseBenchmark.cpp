@@ -0,0 +1,98 @@
+#include "BroadphaseBenchmark.hpp"
+#include <chrono>
+#include <cmath>
+#include <utility>
+#include "Broadphase.hpp"
+
+namespace Application
+{
+	/**
+	 *
+	 */
+	BroadphaseBenchmark::BroadphaseBenchmark() :
+								AbstractBenchmark( "broadphase", { 100, 1000, 10000 })
+	{
+	}
+	/**
+	 *
+	 */
+	void BroadphaseBenchmark::runSize(	int aSize,
+										std::mt19937& aRandom,
+										std::ostream& aLog)
+	{
+		const Size robotSize( 10, 10);
+		const int numberOfTicks = 100;
+
+		int numberOfRobots = aSize;
+		std::uniform_int_distribution< int > coordinate( 0, static_cast< int >( std::sqrt( numberOfRobots) * 40));
+		std::uniform_int_distribution< int > step( -3, 3);
+
+		std::vector< Point > positions;
+		std::vector< Model::BoundedVector > fronts;
+		std::vector< Model::Pose > poses;
+		Model::Broadphase broadphase;
+		for (int i = 0; i < numberOfRobots; ++i)
+		{
+			positions.push_back( Point( coordinate( aRandom), coordinate( aRandom)));
+			fronts.push_back( Model::BoundedVector( step( aRandom), step( aRandom)));
+			poses.push_back( Model::Pose( positions.back(), robotSize, fronts.back()));
+			broadphase.add( poses.back());
+		}
+
+		std::size_t broadphasePairs = 0;
+		std::size_t allPairs = 0;
+		int allPairsTicks = 0;
+		std::chrono::steady_clock::duration broadphaseDuration( 0);
+		std::chrono::steady_clock::duration allPairsDuration( 0);
+		for (int tick = 0; tick < numberOfTicks; ++tick)
+		{
+			for (std::size_t i = 0; i < positions.size(); ++i)
+			{
+				fronts[i] = Model::BoundedVector( step( aRandom), step( aRandom));
+				positions[i] = Point( positions[i].x + static_cast< int >( fronts[i].x), positions[i].y + static_cast< int >( fronts[i].y));
+				poses[i] = Model::Pose( positions[i], robotSize, fronts[i]);
+			}
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (std::size_t i = 0; i < poses.size(); ++i)
+			{
+				broadphase.update( i, poses[i]);
+			}
+			std::vector< std::pair< std::size_t, std::size_t > > pairs;
+			broadphase.findPairs( pairs);
+			broadphaseDuration += std::chrono::steady_clock::now() - start;
+			broadphasePairs += pairs.size();
+
+			if (numberOfRobots <= 1000 || tick < 3)
+			{
+				start = std::chrono::steady_clock::now();
+				std::size_t tickPairs = 0;
+				for (std::size_t i = 0; i < poses.size(); ++i)
+				{
+					for (std::size_t j = i + 1; j < poses.size(); ++j)
+					{
+						if (poses[i].intersects( poses[j]))
+						{
+							++tickPairs;
+						}
+					}
+				}
+				allPairsDuration += std::chrono::steady_clock::now() - start;
+				if (numberOfRobots <= 1000 && tickPairs != pairs.size())
+				{
+					aLog << "the broadphase missed a pair, ";
+				}
+				allPairs += tickPairs;
+				++allPairsTicks;
+			}
+		}
+
+		double broadphaseMilliseconds = std::chrono::duration< double, std::milli >( broadphaseDuration).count() / numberOfTicks;
+		double allPairsMilliseconds = std::chrono::duration< double, std::milli >( allPairsDuration).count() / allPairsTicks;
+		aLog << numberOfRobots << " robots: "
+			 << broadphaseMilliseconds << " ms per tick with the broadphase, "
+			 << allPairsMilliseconds << " ms per tick testing every pair, "
+			 << allPairsMilliseconds / broadphaseMilliseconds << "x, "
+			 << broadphasePairs / numberOfTicks << " and " << allPairs / allPairsTicks << " pairs per tick";
+	}
+} // namespace Application
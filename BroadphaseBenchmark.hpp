@@ -0,0 +1,34 @@
+#ifndef BROADPHASEBENCHMARK_HPP_
+#define BROADPHASEBENCHMARK_HPP_
+
+#include "Config.hpp"
+
+#include "AbstractBenchmark.hpp"
+
+namespace Application
+{
+	/**
+	 * Compares the Broadphase with testing every pair of robots for 100, 1k and 10k robots of 10 by 10
+	 * pixels, a robot per 40 by 40 pixels on average. Every tick all robots move up to 3 pixels in a
+	 * random direction and all pairs that overlap are collected. Testing every pair takes too long for
+	 * 10k robots to do more than a few ticks.
+	 */
+	class BroadphaseBenchmark : public AbstractBenchmark
+	{
+		public:
+			/**
+			 *
+			 */
+			BroadphaseBenchmark();
+
+		protected:
+			/**
+			 *
+			 */
+			virtual void runSize(	int aSize,
+									std::mt19937& aRandom,
+									std::ostream& aLog);
+	};
+	//	class BroadphaseBenchmark
+} // namespace Application
+#endif // BROADPHASEBENCHMARK_HPP_
@@ -0,0 +1,444 @@
+#include "CooperativePlanner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	/* static */const Cost CooperativePlanner::Unreachable;
+	/**
+	 *
+	 */
+	CooperativePlanner::CooperativePlanner(	const Point& aTopLeft,
+											int aWidth,
+											int aHeight,
+											int aClearance,
+											int aCellSize /*= DefaultCellSize*/,
+											int aWindow /*= DefaultWindow*/) :
+												topLeft( aTopLeft),
+												columns( (aWidth - 1) / aCellSize + 1),
+												rows( (aHeight - 1) / aCellSize + 1),
+												clearance( aClearance),
+												cellSize( aCellSize),
+												window( aWindow),
+												startTime( std::chrono::steady_clock::now()),
+												reservationTable( columns, rows, 2 * aWindow + 4),
+												openSet( searchGrid),
+												expansionCount( 0)
+	{
+		if (!Path::fits( topLeft.x, topLeft.y, topLeft.x + columns * cellSize, topLeft.y + rows * cellSize))
+		{
+			throw std::invalid_argument( "CooperativePlanner::CooperativePlanner: the lattice does not fit in a Path");
+		}
+	}
+	/**
+	 *
+	 */
+	/* static */CooperativePlanner& CooperativePlanner::getCooperativePlanner()
+	{
+		static CooperativePlanner cooperativePlanner( Point( 0, 0), 500, 500, 0);
+		return cooperativePlanner;
+	}
+	/**
+	 *
+	 */
+	unsigned long CooperativePlanner::getTime() const
+	{
+		return static_cast< unsigned long >( std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - startTime) / getStepDuration());
+	}
+	/**
+	 *
+	 */
+	std::size_t CooperativePlanner::addAgent(	const Point& aPosition,
+												const Size& aRobotSize)
+	{
+		std::lock_guard< std::mutex > lock( plannerMutex);
+
+		// The larger robot needs room from the others at once, not only once they plan or park again
+		int newClearance = std::max( clearance, OccupancyGrid::getFreeRadius( aRobotSize));
+		if (newClearance != clearance)
+		{
+			clearance = newClearance;
+			for (Agent& agent : agents)
+			{
+				if (agent.active)
+				{
+					restampFootprint( agent);
+				}
+			}
+		}
+
+		std::size_t agent = 0;
+		while (agent < agents.size() && agents[agent].active)
+		{
+			++agent;
+		}
+		if (agent == agents.size())
+		{
+			agents.push_back( Agent());
+		}
+		Agent& newAgent = agents[agent];
+		newAgent.active = true;
+		newAgent.robotSize = aRobotSize;
+		newAgent.occupancyGrid.reset();
+		newAgent.footprintClearance = -1;
+		newAgent.distances.clear();
+		newAgent.moves.reset();
+		newAgent.reserved.clear();
+		newAgent.reservedFrom = 0;
+		newAgent.parked = false;
+		parkAt( newAgent, cellOf( aPosition));
+		return agent;
+	}
+	/**
+	 *
+	 */
+	void CooperativePlanner::removeAgent( std::size_t anAgent)
+	{
+		std::lock_guard< std::mutex > lock( plannerMutex);
+		releaseReservations( agents.at( anAgent));
+		agents[anAgent].active = false;
+	}
+	/**
+	 *
+	 */
+	bool CooperativePlanner::plan(	std::size_t anAgent,
+									const Point& aPosition,
+									const Point& aGoal,
+									unsigned long aTime,
+									Path& aPath)
+	{
+		std::lock_guard< std::mutex > lock( plannerMutex);
+		Agent& agent = agents.at( anAgent);
+		if (!agent.active)
+		{
+			throw std::invalid_argument( "CooperativePlanner::plan: the agent was removed");
+		}
+		releaseReservations( agent);
+		updateFootprint( agent);
+
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( OccupancyGrid::getFreeRadius( agent.robotSize));
+		Point goal = cellOf( aGoal);
+		if (occupancyGrid != agent.occupancyGrid || goal != agent.goal || agent.distances.empty())
+		{
+			agent.occupancyGrid = occupancyGrid;
+			agent.moves = getMoves( occupancyGrid);
+			agent.goal = goal;
+			searchDistances( agent);
+		}
+
+		Point start = cellOf( aPosition);
+		expansionCount = 0;
+		aPath.clear();
+		if (agent.distances[indexOf( start)] == Unreachable)
+		{
+			for (int step = 0; step <= window; ++step)
+			{
+				aPath.push_back( pointOf( start));
+			}
+			return false;
+		}
+
+		// The states of the window: the cell and the step, the step is a row of lattices in the searchGrid
+		openSet.clear();
+		searchGrid.reset( Point( 0, 0), columns, rows * (window + 1));
+		std::uint32_t startIndex = searchGrid.indexOf( start.x, start.y);
+		SearchGrid::Cell startCell = searchGrid.at( startIndex);
+		startCell.actualCost = 0;
+		startCell.parent = SearchGrid::NoCell;
+		openSet.push( startIndex, agent.distances[indexOf( start)], 0);
+
+		// The deepest state that was reached, the end of the route if no state at the end of the window can be
+		std::uint32_t last = SearchGrid::NoCell;
+		std::uint32_t deepest = startIndex;
+		while (!openSet.empty())
+		{
+			std::uint32_t currentIndex = openSet.top();
+			openSet.pop();
+			SearchGrid::Cell current = searchGrid.at( currentIndex);
+			current.state = SearchGrid::Closed;
+			++expansionCount;
+
+			Point state = searchGrid.pointOf( currentIndex);
+			int step = state.y / rows;
+			Point cell( state.x, state.y % rows);
+			if (step > static_cast< int >( searchGrid.pointOf( deepest).y / rows))
+			{
+				deepest = currentIndex;
+			}
+			if (step == window)
+			{
+				last = currentIndex;
+				break;
+			}
+			if (cell == goal)
+			{
+				// The robot stays on its goal for the rest of the window
+				int freeStep = step + 1;
+				while (freeStep <= window && reservationTable.isFree( cell.x, cell.y, aTime + static_cast< unsigned long >( freeStep)))
+				{
+					++freeStep;
+				}
+				if (freeStep > window)
+				{
+					last = currentIndex;
+					break;
+				}
+			}
+
+			// Waiting is a move to the same cell at the next step, it costs as much as a straight move
+			std::uint8_t moves = (*agent.moves)[indexOf( cell)];
+			for (int i = -1; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				if (i >= 0 && (moves & (1 << i)) == 0)
+				{
+					continue;
+				}
+				int x = i < 0 ? cell.x : cell.x + EightConnected::xOffset[i];
+				int y = i < 0 ? cell.y : cell.y + EightConnected::yOffset[i];
+				Cost distance = agent.distances[static_cast< std::size_t >( y) * columns + x];
+				if (distance == Unreachable || !reservationTable.isFree( x, y, aTime + static_cast< unsigned long >( step) + 1))
+				{
+					continue;
+				}
+				Cost cost = current.actualCost + (i < 0 ? StraightCost : EightConnected::stepCost[i]);
+				std::uint32_t index = searchGrid.indexOf( x, y + (step + 1) * rows);
+				SearchGrid::Cell next = searchGrid.at( index);
+				// The heuristic is consistent, a closed state has its lowest cost
+				if (next.state == SearchGrid::Closed || (next.state == SearchGrid::Open && next.actualCost <= cost))
+				{
+					continue;
+				}
+				next.actualCost = cost;
+				next.parent = currentIndex;
+				if (next.state == SearchGrid::Open)
+				{
+					openSet.update( index, cost + distance, cost);
+				} else
+				{
+					openSet.push( index, cost + distance, cost);
+				}
+			}
+		}
+
+		// The robots that planned before box this one in before the end of the window: the route ends at
+		// the deepest state, the robot plans again when it gets there
+		bool boxedIn = last == SearchGrid::NoCell;
+		if (boxedIn)
+		{
+			last = deepest;
+		}
+		for (std::uint32_t index = last; index != SearchGrid::NoCell; index = searchGrid.getParent( index))
+		{
+			Point state = searchGrid.pointOf( index);
+			agent.reserved.push_back( Point( state.x, state.y % rows));
+		}
+		std::reverse( agent.reserved.begin(), agent.reserved.end());
+		if (!boxedIn)
+		{
+			// The robot stays on its goal
+			agent.reserved.resize( static_cast< std::size_t >( window) + 1, agent.reserved.back());
+		} else if (agent.reserved.size() == 1)
+		{
+			// Not even waiting is free, but the robot is there
+			agent.reserved.push_back( start);
+		}
+		// The robot stays at the end of its route until it plans again, at most half a window later. The
+		// end is reserved until all others planned past that time as well, so none of them can run
+		// into it and continuing the route is always free when the robot plans again.
+		std::size_t routeSteps = agent.reserved.size();
+		agent.reserved.resize( static_cast< std::size_t >( 2 * window) + 3, agent.reserved.back());
+		agent.reservedFrom = aTime;
+		for (std::size_t step = 0; step < agent.reserved.size(); ++step)
+		{
+			reservationTable.reserve( agent.footprint, agent.reserved[step].x, agent.reserved[step].y, aTime + step);
+			if (step < routeSteps)
+			{
+				aPath.push_back( pointOf( agent.reserved[step]));
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	void CooperativePlanner::park(	std::size_t anAgent,
+									const Point& aPosition)
+	{
+		std::lock_guard< std::mutex > lock( plannerMutex);
+		Agent& agent = agents.at( anAgent);
+		releaseReservations( agent);
+		parkAt( agent, cellOf( aPosition));
+	}
+	/**
+	 *
+	 */
+	Point CooperativePlanner::cellOf( const Point& aPoint) const
+	{
+		int x = static_cast< int >( std::lround( static_cast< double >( aPoint.x - topLeft.x) / cellSize));
+		int y = static_cast< int >( std::lround( static_cast< double >( aPoint.y - topLeft.y) / cellSize));
+		return Point( std::min( std::max( x, 0), columns - 1), std::min( std::max( y, 0), rows - 1));
+	}
+	/**
+	 *
+	 */
+	CooperativePlanner::MovesPtr CooperativePlanner::getMoves( OccupancyGridPtr anOccupancyGrid)
+	{
+		std::pair< OccupancyGridPtr, MovesPtr >& entry = latticeMoves[anOccupancyGrid->getFreeRadius()];
+		if (entry.first == anOccupancyGrid)
+		{
+			return entry.second;
+		}
+
+		std::shared_ptr< std::vector< std::uint8_t > > moves = std::make_shared< std::vector< std::uint8_t > >( static_cast< std::size_t >( columns) * rows, 0);
+		for (int y = 0; y < rows; ++y)
+		{
+			for (int x = 0; x < columns; ++x)
+			{
+				Point point = pointOf( Point( x, y));
+				if (anOccupancyGrid->isBlocked( point))
+				{
+					continue;
+				}
+				for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+				{
+					Point neighbour( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]);
+					if (neighbour.x >= 0 && neighbour.y >= 0 && neighbour.x < columns && neighbour.y < rows &&
+						anOccupancyGrid->isLineFree( point, pointOf( neighbour)))
+					{
+						(*moves)[indexOf( Point( x, y))] |= static_cast< std::uint8_t >( 1 << i);
+					}
+				}
+			}
+		}
+		entry = std::make_pair( anOccupancyGrid, moves);
+		return entry.second;
+	}
+	/**
+	 *
+	 */
+	void CooperativePlanner::searchDistances( Agent& anAgent)
+	{
+		const std::vector< std::uint8_t >& moves = *anAgent.moves;
+
+		// Dijkstra from the goal, the moves are the same in both directions
+		anAgent.distances.assign( static_cast< std::size_t >( columns) * rows, Unreachable);
+		if (anAgent.occupancyGrid->isBlocked( pointOf( anAgent.goal)))
+		{
+			return;
+		}
+		std::greater< std::pair< Cost, std::size_t > > compare;
+		std::vector< std::pair< Cost, std::size_t > > queue;
+		anAgent.distances[indexOf( anAgent.goal)] = 0;
+		queue.push_back( std::make_pair( 0, indexOf( anAgent.goal)));
+		while (!queue.empty())
+		{
+			std::pop_heap( queue.begin(), queue.end(), compare);
+			std::pair< Cost, std::size_t > entry = queue.back();
+			queue.pop_back();
+			if (entry.first != anAgent.distances[entry.second])
+			{
+				continue;
+			}
+			int x = static_cast< int >( entry.second % columns);
+			int y = static_cast< int >( entry.second / columns);
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				if ((moves[entry.second] & (1 << i)) == 0)
+				{
+					continue;
+				}
+				std::size_t neighbour = indexOf( Point( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]));
+				Cost cost = entry.first + EightConnected::stepCost[i];
+				if (cost < anAgent.distances[neighbour])
+				{
+					anAgent.distances[neighbour] = cost;
+					queue.push_back( std::make_pair( cost, neighbour));
+					std::push_heap( queue.begin(), queue.end(), compare);
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void CooperativePlanner::releaseReservations( Agent& anAgent)
+	{
+		if (anAgent.parked)
+		{
+			reservationTable.unpark( anAgent.footprint, anAgent.reserved.front().x, anAgent.reserved.front().y);
+		} else
+		{
+			for (std::size_t step = 0; step < anAgent.reserved.size(); ++step)
+			{
+				reservationTable.release( anAgent.footprint, anAgent.reserved[step].x, anAgent.reserved[step].y, anAgent.reservedFrom + step);
+			}
+		}
+		anAgent.reserved.clear();
+		anAgent.parked = false;
+	}
+	/**
+	 *
+	 */
+	void CooperativePlanner::parkAt(	Agent& anAgent,
+										const Point& aCell)
+	{
+		updateFootprint( anAgent);
+		reservationTable.park( anAgent.footprint, aCell.x, aCell.y);
+		anAgent.reserved.assign( 1, aCell);
+		anAgent.parked = true;
+	}
+	/**
+	 *
+	 */
+	void CooperativePlanner::updateFootprint( Agent& anAgent)
+	{
+		if (anAgent.footprintClearance == clearance)
+		{
+			return;
+		}
+		// The cells closer than the free radius of the robot plus the clearance
+		int radius = OccupancyGrid::getFreeRadius( anAgent.robotSize) + clearance;
+		int reach = radius / cellSize;
+		anAgent.footprint.clear();
+		for (int dy = -reach; dy <= reach; ++dy)
+		{
+			for (int dx = -reach; dx <= reach; ++dx)
+			{
+				if ((dx * dx + dy * dy) * cellSize * cellSize < radius * radius)
+				{
+					anAgent.footprint.push_back( Point( dx, dy));
+				}
+			}
+		}
+		anAgent.footprintClearance = clearance;
+	}
+	/**
+	 *
+	 */
+	void CooperativePlanner::restampFootprint( Agent& anAgent)
+	{
+		if (anAgent.parked)
+		{
+			Point cell = anAgent.reserved.front();
+			releaseReservations( anAgent);
+			parkAt( anAgent, cell);
+		} else
+		{
+			for (std::size_t step = 0; step < anAgent.reserved.size(); ++step)
+			{
+				reservationTable.release( anAgent.footprint, anAgent.reserved[step].x, anAgent.reserved[step].y, anAgent.reservedFrom + step);
+			}
+			updateFootprint( anAgent);
+			for (std::size_t step = 0; step < anAgent.reserved.size(); ++step)
+			{
+				reservationTable.reserve( anAgent.footprint, anAgent.reserved[step].x, anAgent.reserved[step].y, anAgent.reservedFrom + step);
+			}
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,247 @@
+#ifndef COOPERATIVEPLANNER_HPP_
+#define COOPERATIVEPLANNER_HPP_
+
+#include "Config.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+#include "Path.hpp"
+#include "Point.hpp"
+#include "ReservationTable.hpp"
+#include "SearchGrid.hpp"
+#include "Size.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The CooperativePlanner plans the routes of a fleet of robots around each other with Windowed
+	 * Hierarchical Cooperative A* (WHCA*, Silver). The robots plan one after the other and every route
+	 * is written into a ReservationTable; the next robot searches in space and time and only moves to,
+	 * or waits on, the positions that nobody reserved for that step.
+	 *
+	 * The routes are on a lattice with a point every aCellSize pixels, one point per time step of
+	 * StepDuration: every step a robot moves to a neighbour of its lattice point or waits. Only the
+	 * first aWindow steps are searched and reserved. Beyond the window the heuristic is the true cost to
+	 * the goal on the lattice without the other robots, searched once per goal and walls, so a robot
+	 * that replans every half window follows the shortest route unless it has to give way, and the
+	 * cost of a plan does not grow with the length of the route or the size of the fleet.
+	 *
+	 * A robot reserves the lattice points that are closer to it than its free radius plus the
+	 * clearance, the largest free radius of the robots, so two robots on free points never overlap.
+	 * The steps are short compared to the reserved distance: two robots can not pass through each
+	 * other between two steps.
+	 */
+	class CooperativePlanner : private boost::noncopyable
+	{
+		public:
+			/**
+			 * The agent of addAgent if there is none
+			 */
+			static const std::size_t NoAgent = static_cast< std::size_t >( -1);
+			/**
+			 *
+			 */
+			static const int DefaultCellSize = 10;
+			/**
+			 *
+			 */
+			static const int DefaultWindow = 16;
+			/**
+			 * Plans in the area of aWidth x aHeight pixels from aTopLeft
+			 *
+			 * @param aClearance The free radius of the largest robot, it grows with addAgent
+			 * @throw std::invalid_argument if the points of the area do not fit in a Path
+			 */
+			CooperativePlanner(	const Point& aTopLeft,
+								int aWidth,
+								int aHeight,
+								int aClearance,
+								int aCellSize = DefaultCellSize,
+								int aWindow = DefaultWindow);
+			/**
+			 * The planner that is shared by the robots of the RobotWorld, for its area of 500 x 500 pixels
+			 */
+			static CooperativePlanner& getCooperativePlanner();
+			/**
+			 * The duration of a step, a robot drives to the next point of its route every step
+			 */
+			static std::chrono::milliseconds getStepDuration()
+			{
+				return std::chrono::milliseconds( 100);
+			}
+			/**
+			 *
+			 * @return The number of steps since the planner was created
+			 */
+			unsigned long getTime() const;
+			/**
+			 *
+			 */
+			int getCellSize() const
+			{
+				return cellSize;
+			}
+			/**
+			 *
+			 */
+			int getWindow() const
+			{
+				return window;
+			}
+			/**
+			 * Adds a robot that is parked at aPosition until it plans. If the robot is larger than the
+			 * clearance, the footprints of the other robots grow with the clearance.
+			 *
+			 * @return The agent of the robot
+			 */
+			std::size_t addAgent(	const Point& aPosition,
+									const Size& aRobotSize);
+			/**
+			 * Releases all reservations of anAgent
+			 */
+			void removeAgent( std::size_t anAgent);
+			/**
+			 * Plans the route of anAgent from aPosition at aTime for the next window and reserves it.
+			 * The route has a point for every step from aTime to aTime + getWindow(), the robot waits
+			 * where it has to give way. If the robots that planned before box it in, the route is
+			 * shorter and the robot must plan again at its end.
+			 *
+			 * @return false if aGoal can not be reached at all, in which case aPath is the current
+			 * 		   position for every step
+			 */
+			bool plan(	std::size_t anAgent,
+						const Point& aPosition,
+						const Point& aGoal,
+						unsigned long aTime,
+						Path& aPath);
+			/**
+			 * Parks anAgent at aPosition: its footprint is reserved at all steps until it plans again
+			 */
+			void park(	std::size_t anAgent,
+						const Point& aPosition);
+			/**
+			 *
+			 * @return The number of space-time states expanded by the last plan
+			 */
+			unsigned long getExpansionCount() const
+			{
+				return expansionCount;
+			}
+
+		private:
+			/**
+			 * The distance to the goal of a cell without a route to the goal
+			 */
+			static const Cost Unreachable = 0xFFFFFFFFu;
+			/**
+			 * The moves from every cell to its free neighbours, bit i is EightConnected direction i
+			 */
+			typedef std::shared_ptr< const std::vector< std::uint8_t > > MovesPtr;
+			/**
+			 *
+			 */
+			struct Agent
+			{
+					bool active;
+					Size robotSize;
+					OccupancyGridPtr occupancyGrid;
+					/**
+					 * The footprint for the radius of the robot and the clearance it was made for
+					 */
+					ReservationTable::Footprint footprint;
+					int footprintClearance;
+					/**
+					 * The goal cell and the costs to it, searched for the occupancyGrid
+					 */
+					Point goal;
+					std::vector< Cost > distances;
+					MovesPtr moves;
+					/**
+					 * The cells of the reserved route from the step reservedFrom, or the cell it is parked on
+					 */
+					std::vector< Point > reserved;
+					unsigned long reservedFrom;
+					bool parked;
+			};
+			/**
+			 * The lattice cell nearest to aPoint, clamped to the area
+			 */
+			Point cellOf( const Point& aPoint) const;
+			/**
+			 *
+			 */
+			Point pointOf( const Point& aCell) const
+			{
+				return Point( topLeft.x + aCell.x * cellSize, topLeft.y + aCell.y * cellSize);
+			}
+			/**
+			 *
+			 */
+			std::size_t indexOf( const Point& aCell) const
+			{
+				return static_cast< std::size_t >( aCell.y) * columns + aCell.x;
+			}
+			/**
+			 * The moves for anOccupancyGrid, shared by all robots with its free radius
+			 */
+			MovesPtr getMoves( OccupancyGridPtr anOccupancyGrid);
+			/**
+			 * Searches the costs from every cell to the goal of anAgent on the lattice, without the
+			 * other robots
+			 */
+			void searchDistances( Agent& anAgent);
+			/**
+			 *
+			 */
+			void releaseReservations( Agent& anAgent);
+			/**
+			 * Reserves the footprint of anAgent around aCell at all steps
+			 */
+			void parkAt(	Agent& anAgent,
+							const Point& aCell);
+			/**
+			 * Makes the footprint of anAgent for the current clearance
+			 */
+			void updateFootprint( Agent& anAgent);
+			/**
+			 * Replaces the reservations of anAgent, parked or on its route, with those of its footprint
+			 * for the current clearance
+			 */
+			void restampFootprint( Agent& anAgent);
+
+			Point topLeft;
+			int columns;
+			int rows;
+			int clearance;
+			int cellSize;
+			int window;
+			std::chrono::steady_clock::time_point startTime;
+			std::vector< Agent > agents;
+			/**
+			 * The moves per free radius and the OccupancyGrid they were made for
+			 */
+			std::map< int, std::pair< OccupancyGridPtr, MovesPtr > > latticeMoves;
+			ReservationTable reservationTable;
+			/**
+			 * The space-time states of a search: the lattice stacked window + 1 times, the state of
+			 * cell (x,y) at step k is the SearchGrid cell (x, y + k * rows)
+			 */
+			SearchGrid searchGrid;
+			OpenSet openSet;
+			unsigned long expansionCount;
+			/**
+			 * The robots plan one at a time, each against the reservations of the ones before
+			 */
+			mutable std::mutex plannerMutex;
+	}; // class CooperativePlanner
+} // namespace PathAlgorithm
+#endif // COOPERATIVEPLANNER_HPP_
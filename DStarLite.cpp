@@ -0,0 +1,335 @@
+#include "DStarLite.hpp"
+#include <algorithm>
+#include "RobotWorld.hpp"
+
+namespace PathAlgorithm
+{
+	/* static */const Cost DStarLite::Unreachable;
+	/* static */const std::uint32_t DStarLite::NotQueued;
+	/**
+	 *
+	 */
+	DStarLite::DStarLite() :
+								freeRadius( -1),
+								start( 0, 0),
+								goal( 0, 0),
+								keyModifier( 0),
+								topLeft( 0, 0),
+								width( 0),
+								height( 0),
+								expansionCount( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	bool DStarLite::search(	const Point& aStartPoint,
+							const Point& aGoalPoint,
+							const Size& aRobotSize,
+							Path& aPath)
+	{
+		aPath.clear();
+		expansionCount = 0;
+
+		int radius = OccupancyGrid::getFreeRadius( aRobotSize);
+		OccupancyGridPtr newGrid = OccupancyGrid::getOccupancyGrid( radius);
+
+		// The area must hold the start, the goal and the inflated walls plus a border of one cell, as in AStar
+		int left = std::min( aStartPoint.x, aGoalPoint.x);
+		int top = std::min( aStartPoint.y, aGoalPoint.y);
+		int right = std::max( aStartPoint.x, aGoalPoint.x);
+		int bottom = std::max( aStartPoint.y, aGoalPoint.y);
+		if (newGrid->getWidth() > 0)
+		{
+			left = std::min( left, newGrid->getOrigin().x);
+			top = std::min( top, newGrid->getOrigin().y);
+			right = std::max( right, newGrid->getOrigin().x + newGrid->getWidth() - 1);
+			bottom = std::max( bottom, newGrid->getOrigin().y + newGrid->getHeight() - 1);
+		}
+		if (!Path::fits( left - 1, top - 1, right + 1, bottom + 1))
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << ", the area does not fit in a Path" << std::endl;
+			return false;
+		}
+		bool fits = contains( left - 1, top - 1) && contains( right + 1, bottom + 1);
+
+		std::vector< Model::WallChange > changes;
+		if (!occupancyGrid || radius != freeRadius || aGoalPoint != goal || !fits ||
+			(newGrid->getWallRevision() != occupancyGrid->getWallRevision() && !Model::RobotWorld::getRobotWorld().getWallChangesSince( occupancyGrid->getWallRevision(), changes)))
+		{
+			freeRadius = radius;
+			occupancyGrid = newGrid;
+			topLeft = Point( left - 1, top - 1);
+			width = right - left + 3;
+			height = bottom - top + 3;
+			initialise( aStartPoint, aGoalPoint);
+		} else
+		{
+			// The start moved: all keys in the queue are too high by at most the heuristic cost
+			// between the old and the new start
+			keyModifier = add( keyModifier, OctileHeuristic::estimate( aStartPoint.x - start.x, aStartPoint.y - start.y));
+			start = aStartPoint;
+
+			OccupancyGridPtr oldGrid = occupancyGrid;
+			occupancyGrid = newGrid;
+			for (const Model::WallChange& change : changes)
+			{
+				updateOccupancy(	*oldGrid,
+									std::min( change.point1.x, change.point2.x) - freeRadius,
+									std::min( change.point1.y, change.point2.y) - freeRadius,
+									std::max( change.point1.x, change.point2.x) + freeRadius,
+									std::max( change.point1.y, change.point2.y) + freeRadius);
+			}
+		}
+
+		computeShortestPath();
+
+		std::uint32_t current = indexOf( start.x, start.y);
+		if (g[current] == Unreachable)
+		{
+			std::cerr << "**** No route from " << start << " to " << goal << std::endl;
+			return false;
+		}
+
+		// Follow the cheapest successor, the cost to the goal decreases with every step
+		Point point = start;
+		aPath.push_back( point);
+		while (point != goal && aPath.size() <= static_cast< std::size_t >( width) * height)
+		{
+			int best = -1;
+			Cost bestCost = Unreachable;
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				Cost cost = costVia( point.x + EightConnected::xOffset[i], point.y + EightConnected::yOffset[i], EightConnected::stepCost[i]);
+				if (cost < bestCost)
+				{
+					best = i;
+					bestCost = cost;
+				}
+			}
+			if (best == -1)
+			{
+				aPath.clear();
+				return false;
+			}
+			point = Point( point.x + EightConnected::xOffset[best], point.y + EightConnected::yOffset[best]);
+			current = indexOf( point.x, point.y);
+			aPath.push_back( point);
+		}
+		return point == goal;
+	}
+	/**
+	 *
+	 */
+	void DStarLite::initialise(	const Point& aStartPoint,
+								const Point& aGoalPoint)
+	{
+		start = aStartPoint;
+		goal = aGoalPoint;
+		keyModifier = 0;
+
+		std::size_t size = static_cast< std::size_t >( width) * height;
+		g.assign( size, Unreachable);
+		rhs.assign( size, Unreachable);
+		queueSlot.assign( size, NotQueued);
+		queue.clear();
+
+		std::uint32_t goalCell = indexOf( goal.x, goal.y);
+		rhs[goalCell] = 0;
+		queuePush( goalCell, calculateKey( goalCell));
+	}
+	/**
+	 *
+	 */
+	void DStarLite::updateOccupancy(	const OccupancyGrid& anOldGrid,
+										int aLeft,
+										int aTop,
+										int aRight,
+										int aBottom)
+	{
+		// The cost of a move into a changed cell changed and with it the cost to the goal of its neighbours
+		for (int y = std::max( aTop, topLeft.y); y <= std::min( aBottom, topLeft.y + height - 1); ++y)
+		{
+			for (int x = std::max( aLeft, topLeft.x); x <= std::min( aRight, topLeft.x + width - 1); ++x)
+			{
+				if (anOldGrid.isBlocked( x, y) != occupancyGrid->isBlocked( x, y))
+				{
+					for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+					{
+						if (contains( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+						{
+							updateVertex( indexOf( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]));
+						}
+					}
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void DStarLite::computeShortestPath()
+	{
+		std::uint32_t startCell = indexOf( start.x, start.y);
+		while (!queue.empty() && (queue.front().key < calculateKey( startCell) || rhs[startCell] != g[startCell]))
+		{
+			++expansionCount;
+
+			std::uint32_t cell = queue.front().cell;
+			Key oldKey = queue.front().key;
+			Key newKey = calculateKey( cell);
+			if (oldKey < newKey)
+			{
+				queue.front().key = newKey;
+				queueSiftDown( 0);
+				continue;
+			}
+
+			int x = topLeft.x + static_cast< int >( cell % width);
+			int y = topLeft.y + static_cast< int >( cell / width);
+			if (g[cell] > rhs[cell])
+			{
+				g[cell] = rhs[cell];
+				queueRemove( cell);
+			} else
+			{
+				g[cell] = Unreachable;
+				updateVertex( cell);
+			}
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				if (contains( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+				{
+					updateVertex( indexOf( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]));
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void DStarLite::updateVertex( std::uint32_t aCell)
+	{
+		int x = topLeft.x + static_cast< int >( aCell % width);
+		int y = topLeft.y + static_cast< int >( aCell / width);
+		if (x != goal.x || y != goal.y)
+		{
+			Cost cost = Unreachable;
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				cost = std::min( cost, costVia( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i], EightConnected::stepCost[i]));
+			}
+			rhs[aCell] = cost;
+		}
+		if (queueSlot[aCell] != NotQueued)
+		{
+			queueRemove( aCell);
+		}
+		if (g[aCell] != rhs[aCell])
+		{
+			queuePush( aCell, calculateKey( aCell));
+		}
+	}
+	/**
+	 *
+	 */
+	Cost DStarLite::costVia(	int anX,
+								int anY,
+								Cost aStepCost) const
+	{
+		if (!contains( anX, anY) || occupancyGrid->isBlocked( anX, anY))
+		{
+			return Unreachable;
+		}
+		return add( aStepCost, g[indexOf( anX, anY)]);
+	}
+	/**
+	 *
+	 */
+	DStarLite::Key DStarLite::calculateKey( std::uint32_t aCell) const
+	{
+		Cost cost = std::min( g[aCell], rhs[aCell]);
+		Cost heuristicCost = OctileHeuristic::estimate( topLeft.x + static_cast< int >( aCell % width) - start.x, topLeft.y + static_cast< int >( aCell / width) - start.y);
+		Key key = { add( add( cost, heuristicCost), keyModifier), cost };
+		return key;
+	}
+	/**
+	 *
+	 */
+	void DStarLite::queuePush(	std::uint32_t aCell,
+								const Key& aKey)
+	{
+		QueueEntry entry = { aKey, aCell };
+		queue.push_back( entry);
+		queueSlot[aCell] = static_cast< std::uint32_t >( queue.size() - 1);
+		queueSiftUp( queue.size() - 1);
+	}
+	/**
+	 *
+	 */
+	void DStarLite::queueRemove( std::uint32_t aCell)
+	{
+		std::size_t slot = queueSlot[aCell];
+		queueSlot[aCell] = NotQueued;
+		if (slot != queue.size() - 1)
+		{
+			queue[slot] = queue.back();
+			queueSlot[queue[slot].cell] = static_cast< std::uint32_t >( slot);
+			queue.pop_back();
+			queueSiftUp( slot);
+			queueSiftDown( slot);
+		} else
+		{
+			queue.pop_back();
+		}
+	}
+	/**
+	 *
+	 */
+	void DStarLite::queueSiftUp( std::size_t aSlot)
+	{
+		QueueEntry entry = queue[aSlot];
+		while (aSlot > 0)
+		{
+			std::size_t parent = (aSlot - 1) / 2;
+			if (!(entry.key < queue[parent].key))
+			{
+				break;
+			}
+			queue[aSlot] = queue[parent];
+			queueSlot[queue[aSlot].cell] = static_cast< std::uint32_t >( aSlot);
+			aSlot = parent;
+		}
+		queue[aSlot] = entry;
+		queueSlot[entry.cell] = static_cast< std::uint32_t >( aSlot);
+	}
+	/**
+	 *
+	 */
+	void DStarLite::queueSiftDown( std::size_t aSlot)
+	{
+		QueueEntry entry = queue[aSlot];
+		const std::size_t size = queue.size();
+		for (;;)
+		{
+			std::size_t child = 2 * aSlot + 1;
+			if (child >= size)
+			{
+				break;
+			}
+			if (child + 1 < size && queue[child + 1].key < queue[child].key)
+			{
+				++child;
+			}
+			if (!(queue[child].key < entry.key))
+			{
+				break;
+			}
+			queue[aSlot] = queue[child];
+			queueSlot[queue[aSlot].cell] = static_cast< std::uint32_t >( aSlot);
+			aSlot = child;
+		}
+		queue[aSlot] = entry;
+		queueSlot[entry.cell] = static_cast< std::uint32_t >( aSlot);
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,189 @@
+#ifndef DSTARLITE_HPP_
+#define DSTARLITE_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+#include "Point.hpp"
+#include "Size.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * DStarLite is an incremental planner (D* Lite, Koenig and Likhachev) on the OccupancyGrid with the
+	 * neighbours and costs of AStar. It searches backwards from the goal and keeps its search state
+	 * between calls to search for the same goal and robot size:
+	 *
+	 * - if the start moved, only the priorities are corrected (the km of D* Lite), nothing is searched again;
+	 * - if walls changed, only the cells whose occupancy changed are updated, found through
+	 *   RobotWorld::getWallChangesSince, and the search repairs the costs that depend on them.
+	 *
+	 * A replan after a small change therefore expands a fraction of the cells of a full search, so
+	 * that a robot can replan while driving. The search starts from scratch if the goal or the robot
+	 * size changes or if the walls grow out of the area of the search.
+	 */
+	class DStarLite : private boost::noncopyable
+	{
+		public:
+			/**
+			 *
+			 */
+			DStarLite();
+			/**
+			 *
+			 * @param aPath Receives the path from aStartPoint to aGoalPoint, its buffer is reused
+			 * @return false if there is no route, aPath is empty in that case
+			 */
+			bool search(	const Point& aStartPoint,
+							const Point& aGoalPoint,
+							const Size& aRobotSize,
+							Path& aPath);
+			/**
+			 *
+			 * @return The wall revision of the RobotWorld the last search was done for
+			 */
+			unsigned long getWallRevision() const
+			{
+				return occupancyGrid ? occupancyGrid->getWallRevision() : 0;
+			}
+			/**
+			 *
+			 * @return The number of cells expanded by the last search
+			 */
+			std::size_t getExpansionCount() const
+			{
+				return expansionCount;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			struct Key
+			{
+					Cost first;
+					Cost second;
+
+					bool operator<( const Key& aKey) const
+					{
+						return first < aKey.first || (first == aKey.first && second < aKey.second);
+					}
+			};
+			/**
+			 *
+			 */
+			struct QueueEntry
+			{
+					Key key;
+					std::uint32_t cell;
+			};
+			/**
+			 * Throws away all search state and starts a new search in an area that holds the start,
+			 * the goal and all blocked cells
+			 */
+			void initialise(	const Point& aStartPoint,
+								const Point& aGoalPoint);
+			/**
+			 * Updates the neighbours of the cells in the rectangle whose occupancy differs between
+			 * anOldGrid and the current grid
+			 */
+			void updateOccupancy(	const OccupancyGrid& anOldGrid,
+									int aLeft,
+									int aTop,
+									int aRight,
+									int aBottom);
+			/**
+			 *
+			 */
+			void computeShortestPath();
+			/**
+			 *
+			 */
+			void updateVertex( std::uint32_t aCell);
+			/**
+			 *
+			 * @return aStepCost plus the cost from the cell at (anX,anY) to the goal, Unreachable if that
+			 * 			cell is blocked, outside the area or has no route to the goal
+			 */
+			Cost costVia(	int anX,
+							int anY,
+							Cost aStepCost) const;
+			/**
+			 *
+			 */
+			Key calculateKey( std::uint32_t aCell) const;
+			/**
+			 *
+			 * @return aCost1 + aCost2, or Unreachable if the sum does not fit
+			 */
+			static Cost add(	Cost aCost1,
+								Cost aCost2)
+			{
+				return aCost1 < Unreachable - aCost2 ? aCost1 + aCost2 : Unreachable;
+			}
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= topLeft.x && anY >= topLeft.y && anX < topLeft.x + width && anY < topLeft.y + height;
+			}
+			/**
+			 *
+			 */
+			std::uint32_t indexOf(	int anX,
+									int anY) const
+			{
+				return static_cast< std::uint32_t >( (anY - topLeft.y) * width + (anX - topLeft.x));
+			}
+			/**
+			 *
+			 */
+			void queuePush(	std::uint32_t aCell,
+							const Key& aKey);
+			/**
+			 *
+			 */
+			void queueRemove( std::uint32_t aCell);
+			/**
+			 *
+			 */
+			void queueSiftUp( std::size_t aSlot);
+			/**
+			 *
+			 */
+			void queueSiftDown( std::size_t aSlot);
+
+			/**
+			 * The cost to the goal of a cell without a route to the goal
+			 */
+			static const Cost Unreachable = 0xFFFFFFFFu;
+			static const std::uint32_t NotQueued = 0xFFFFFFFF;
+
+			OccupancyGridPtr occupancyGrid;
+			int freeRadius;
+			Point start;
+			Point goal;
+			/**
+			 * The sum of the heuristic costs between all starts so far, km in D* Lite
+			 */
+			Cost keyModifier;
+
+			Point topLeft;
+			int width;
+			int height;
+			std::vector< Cost > g;
+			std::vector< Cost > rhs;
+			std::vector< std::uint32_t > queueSlot;
+			std::vector< QueueEntry > queue;
+
+			std::size_t expansionCount;
+	}; // class DStarLite
+} // namespace PathAlgorithm
+#endif // DSTARLITE_HPP_
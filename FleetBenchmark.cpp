@@ -0,0 +1,91 @@
+#include "FleetBenchmark.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "CooperativePlanner.hpp"
+#include "OccupancyGrid.hpp"
+
+namespace Application
+{
+	/**
+	 *
+	 */
+	FleetBenchmark::FleetBenchmark() :
+								AbstractBenchmark( "fleet", { 25, 50, 100, 200, 400 })
+	{
+	}
+	/**
+	 *
+	 */
+	void FleetBenchmark::runSize(	int aSize,
+									std::mt19937& aRandom,
+									std::ostream& aLog)
+	{
+		const Size robotSize( 10, 10);
+		const int spacing = 40;
+		const unsigned long maximumSteps = 1000;
+		int radius = PathAlgorithm::OccupancyGrid::getFreeRadius( robotSize);
+		PathAlgorithm::OccupancyGridPtr occupancyGrid = PathAlgorithm::OccupancyGrid::getOccupancyGrid( radius);
+		Point origin( occupancyGrid->getWidth() > 0 ? occupancyGrid->getOrigin().x + occupancyGrid->getWidth() : 0, 0);
+
+		int numberOfRobots = aSize;
+		int side = static_cast< int >( std::ceil( std::sqrt( numberOfRobots)));
+		PathAlgorithm::CooperativePlanner planner( origin, (side + 1) * spacing, (side + 1) * spacing, radius);
+
+		std::vector< Point > positions;
+		for (int i = 0; i < numberOfRobots; ++i)
+		{
+			positions.push_back( Point( origin.x + (i % side + 1) * spacing, origin.y + (i / side + 1) * spacing));
+		}
+		std::vector< Point > goals( positions);
+		std::shuffle( goals.begin(), goals.end(), aRandom);
+
+		std::vector< std::size_t > agents;
+		for (const Point& position : positions)
+		{
+			agents.push_back( planner.addAgent( position, robotSize));
+		}
+		std::vector< PathAlgorithm::Path > paths( positions.size());
+		std::vector< unsigned long > routeTimes( positions.size(), 0);
+
+		unsigned long plans = 0;
+		unsigned long expansions = 0;
+		std::chrono::steady_clock::duration planDuration( 0);
+		unsigned long step = 0;
+		int arrived = 0;
+		for (; step < maximumSteps && arrived < numberOfRobots; ++step)
+		{
+			arrived = 0;
+			for (int j = 0; j < numberOfRobots; ++j)
+			{
+				// The robot that plans first changes every step
+				std::size_t i = static_cast< std::size_t >( (j + step) % numberOfRobots);
+				std::size_t routeStep = paths[i].empty() ? 0 : std::min( static_cast< std::size_t >( step - routeTimes[i]), paths[i].size() - 1);
+				if (!paths[i].empty())
+				{
+					positions[i] = paths[i][routeStep];
+				}
+				if (paths[i].empty() || routeStep >= static_cast< std::size_t >( planner.getWindow() / 2) || routeStep + 1 == paths[i].size())
+				{
+					std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+					planner.plan( agents[i], positions[i], goals[i], step, paths[i]);
+					planDuration += std::chrono::steady_clock::now() - start;
+					expansions += planner.getExpansionCount();
+					routeTimes[i] = step;
+					++plans;
+				}
+				if (positions[i] == goals[i])
+				{
+					++arrived;
+				}
+			}
+		}
+
+		double milliseconds = std::chrono::duration< double, std::milli >( planDuration).count();
+		aLog << numberOfRobots << " robots: " << plans << " plans in " << milliseconds << " ms, "
+			 << static_cast< long >( plans / (milliseconds / 1000.0)) << " plans/s, "
+			 << expansions / std::max( 1ul, plans) << " expansions per plan, "
+			 << milliseconds / std::max( 1ul, step) << " ms per step, "
+			 << arrived << " arrived after " << step << " steps";
+	}
+} // namespace Application
@@ -0,0 +1,34 @@
+#ifndef FLEETBENCHMARK_HPP_
+#define FLEETBENCHMARK_HPP_
+
+#include "Config.hpp"
+
+#include "AbstractBenchmark.hpp"
+
+namespace Application
+{
+	/**
+	 * Measures the planning throughput of the CooperativePlanner for fleets of 25 to 400 robots. The
+	 * robots stand on a lattice next to the walls of the world and drive to the shuffled points of the
+	 * same lattice. Every step the robots plan in turn as they do while driving, every half window or
+	 * at the end of a shorter route, without waiting for the steps.
+	 */
+	class FleetBenchmark : public AbstractBenchmark
+	{
+		public:
+			/**
+			 *
+			 */
+			FleetBenchmark();
+
+		protected:
+			/**
+			 *
+			 */
+			virtual void runSize(	int aSize,
+									std::mt19937& aRandom,
+									std::ostream& aLog);
+	};
+	//	class FleetBenchmark
+} // namespace Application
+#endif // FLEETBENCHMARK_HPP_
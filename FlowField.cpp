@@ -0,0 +1,312 @@
+#include "FlowField.hpp"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include "RobotWorld.hpp"
+
+namespace PathAlgorithm
+{
+	/* static */const Cost FlowField::Unreachable;
+	/**
+	 *
+	 */
+	/* static */const std::uint8_t FlowField::NoDirection;
+	/**
+	 *
+	 */
+	FlowField::FlowField(	const Point& aGoalPoint,
+							OccupancyGridPtr anOccupancyGrid,
+							const Point& aTopLeft,
+							int aWidth,
+							int aHeight) :
+								goal( aGoalPoint),
+								occupancyGrid( anOccupancyGrid),
+								topLeft( aTopLeft),
+								width( aWidth),
+								height( aHeight),
+								costs( static_cast< std::size_t >( aWidth) * aHeight, Unreachable),
+								directions( static_cast< std::size_t >( aWidth) * aHeight, NoDirection),
+								expansionCount( 0)
+	{
+		if (!occupancyGrid->isBlocked( goal))
+		{
+			push( indexOf( goal.x, goal.y), 0);
+		}
+		expand();
+	}
+	/**
+	 *
+	 */
+	FlowField::FlowField(	const FlowField& aPrevious,
+							OccupancyGridPtr anOccupancyGrid,
+							const std::vector< Model::WallChange >& aChanges) :
+								goal( aPrevious.goal),
+								occupancyGrid( anOccupancyGrid),
+								topLeft( aPrevious.topLeft),
+								width( aPrevious.width),
+								height( aPrevious.height),
+								costs( aPrevious.costs),
+								directions( aPrevious.directions),
+								expansionCount( 0)
+	{
+		int radius = occupancyGrid->getFreeRadius();
+		for (const Model::WallChange& change : aChanges)
+		{
+			repair(	*aPrevious.occupancyGrid,
+					std::min( change.point1.x, change.point2.x) - radius,
+					std::min( change.point1.y, change.point2.y) - radius,
+					std::max( change.point1.x, change.point2.x) + radius,
+					std::max( change.point1.y, change.point2.y) + radius);
+		}
+		expand();
+	}
+	/**
+	 *
+	 */
+	/* static */FlowFieldPtr FlowField::getFlowField(	const Point& aGoalPoint,
+														const Size& aRobotSize,
+														const Point& aStartPoint)
+	{
+		static std::mutex cacheMutex;
+		static std::map< std::tuple< int, int, int >, FlowFieldPtr > cache;
+
+		int radius = OccupancyGrid::getFreeRadius( aRobotSize);
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( radius);
+
+		// The area must hold the start, the goal and the inflated walls plus a border of one cell, as in AStar
+		int left = std::min( aStartPoint.x, aGoalPoint.x);
+		int top = std::min( aStartPoint.y, aGoalPoint.y);
+		int right = std::max( aStartPoint.x, aGoalPoint.x);
+		int bottom = std::max( aStartPoint.y, aGoalPoint.y);
+		if (occupancyGrid->getWidth() > 0)
+		{
+			left = std::min( left, occupancyGrid->getOrigin().x);
+			top = std::min( top, occupancyGrid->getOrigin().y);
+			right = std::max( right, occupancyGrid->getOrigin().x + occupancyGrid->getWidth() - 1);
+			bottom = std::max( bottom, occupancyGrid->getOrigin().y + occupancyGrid->getHeight() - 1);
+		}
+
+		// The field is searched under the lock: the robots that drive to the same goal wait for the
+		// one search instead of each doing their own
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		FlowFieldPtr& field = cache[std::make_tuple( aGoalPoint.x, aGoalPoint.y, radius)];
+		std::vector< Model::WallChange > changes;
+		if (field && !(field->contains( left - 1, top - 1) && field->contains( right + 1, bottom + 1)))
+		{
+			// A robot outside of the area: the new area holds the old one as well
+			left = std::min( left, field->topLeft.x + 1);
+			top = std::min( top, field->topLeft.y + 1);
+			right = std::max( right, field->topLeft.x + field->width - 2);
+			bottom = std::max( bottom, field->topLeft.y + field->height - 2);
+			field.reset();
+		}
+		if (!field ||
+			(field->getWallRevision() != occupancyGrid->getWallRevision() && !Model::RobotWorld::getRobotWorld().getWallChangesSince( field->getWallRevision(), changes)))
+		{
+			field = std::make_shared< const FlowField >( aGoalPoint, occupancyGrid, Point( left - 1, top - 1), right - left + 3, bottom - top + 3);
+		} else if (field->getWallRevision() != occupancyGrid->getWallRevision())
+		{
+			field = std::make_shared< const FlowField >( *field, occupancyGrid, changes);
+		}
+		return field;
+	}
+	/**
+	 *
+	 */
+	double FlowField::getCost( const Point& aPoint) const
+	{
+		if (!contains( aPoint.x, aPoint.y) || costs[indexOf( aPoint.x, aPoint.y)] == Unreachable)
+		{
+			return std::numeric_limits< double >::infinity();
+		}
+		return static_cast< double >( costs[indexOf( aPoint.x, aPoint.y)]) / StraightCost;
+	}
+	/**
+	 *
+	 */
+	bool FlowField::getNext(	const Point& aPoint,
+								Point& aNext) const
+	{
+		if (!contains( aPoint.x, aPoint.y))
+		{
+			return false;
+		}
+		std::uint8_t direction = directions[indexOf( aPoint.x, aPoint.y)];
+		if (direction == NoDirection && occupancyGrid->isBlocked( aPoint) && aPoint != goal)
+		{
+			Cost bestCost = Unreachable;
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				int x = aPoint.x + EightConnected::xOffset[i];
+				int y = aPoint.y + EightConnected::yOffset[i];
+				if (contains( x, y) && costs[indexOf( x, y)] != Unreachable && costs[indexOf( x, y)] + EightConnected::stepCost[i] < bestCost)
+				{
+					bestCost = costs[indexOf( x, y)] + EightConnected::stepCost[i];
+					direction = static_cast< std::uint8_t >( i);
+				}
+			}
+		}
+		if (direction == NoDirection)
+		{
+			return false;
+		}
+		aNext = Point( aPoint.x + EightConnected::xOffset[direction], aPoint.y + EightConnected::yOffset[direction]);
+		return true;
+	}
+	/**
+	 *
+	 */
+	bool FlowField::getPath(	const Point& aStartPoint,
+								Path& aPath) const
+	{
+		aPath.clear();
+		if (!Path::fits( topLeft.x, topLeft.y, topLeft.x + width - 1, topLeft.y + height - 1))
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << goal << ", the area does not fit in a Path" << std::endl;
+			return false;
+		}
+		Point point = aStartPoint;
+		aPath.push_back( point);
+		while (point != goal)
+		{
+			if (!getNext( point, point) || aPath.size() > costs.size())
+			{
+				aPath.clear();
+				return false;
+			}
+			aPath.push_back( point);
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	void FlowField::repair(	const OccupancyGrid& anOldGrid,
+							int aLeft,
+							int aTop,
+							int aRight,
+							int aBottom)
+	{
+		std::vector< std::uint32_t > invalid;
+		for (int y = std::max( aTop, topLeft.y); y <= std::min( aBottom, topLeft.y + height - 1); ++y)
+		{
+			for (int x = std::max( aLeft, topLeft.x); x <= std::min( aRight, topLeft.x + width - 1); ++x)
+			{
+				if (anOldGrid.isBlocked( x, y) != occupancyGrid->isBlocked( x, y))
+				{
+					std::uint32_t index = indexOf( x, y);
+					costs[index] = Unreachable;
+					directions[index] = NoDirection;
+					invalid.push_back( index);
+				}
+			}
+		}
+
+		// The routes of the cells that step into an invalid cell are invalid as well: the cells are
+		// a tree with the goal as root, the subtrees of the changed cells are invalidated
+		for (std::size_t i = 0; i < invalid.size(); ++i)
+		{
+			Point point = pointOf( invalid[i]);
+			for (int j = 0; j < EightConnected::numberOfNeighbours; ++j)
+			{
+				int x = point.x + EightConnected::xOffset[j];
+				int y = point.y + EightConnected::yOffset[j];
+				if (!contains( x, y))
+				{
+					continue;
+				}
+				std::uint32_t neighbour = indexOf( x, y);
+				// The neighbour steps back into point with the opposite direction
+				if (directions[neighbour] == (j + 4) % EightConnected::numberOfNeighbours)
+				{
+					costs[neighbour] = Unreachable;
+					directions[neighbour] = NoDirection;
+					invalid.push_back( neighbour);
+				}
+			}
+		}
+
+		// An invalid cell starts from its cheapest valid neighbour, the search corrects the rest
+		std::uint32_t goalIndex = indexOf( goal.x, goal.y);
+		for (std::uint32_t index : invalid)
+		{
+			Point point = pointOf( index);
+			if (occupancyGrid->isBlocked( point))
+			{
+				continue;
+			}
+			if (index == goalIndex)
+			{
+				push( index, 0);
+				continue;
+			}
+			for (int j = 0; j < EightConnected::numberOfNeighbours; ++j)
+			{
+				int x = point.x + EightConnected::xOffset[j];
+				int y = point.y + EightConnected::yOffset[j];
+				if (contains( x, y) && costs[indexOf( x, y)] != Unreachable && costs[indexOf( x, y)] + EightConnected::stepCost[j] < costs[index])
+				{
+					costs[index] = costs[indexOf( x, y)] + EightConnected::stepCost[j];
+					directions[index] = static_cast< std::uint8_t >( j);
+				}
+			}
+			if (costs[index] != Unreachable)
+			{
+				push( index, costs[index]);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void FlowField::expand()
+	{
+		std::greater< std::pair< Cost, std::uint32_t > > compare;
+		while (!queue.empty())
+		{
+			std::pop_heap( queue.begin(), queue.end(), compare);
+			std::pair< Cost, std::uint32_t > entry = queue.back();
+			queue.pop_back();
+			if (entry.first != costs[entry.second])
+			{
+				// The cost of the cell was lowered after this entry was queued
+				continue;
+			}
+			++expansionCount;
+
+			Point point = pointOf( entry.second);
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				int x = point.x + EightConnected::xOffset[i];
+				int y = point.y + EightConnected::yOffset[i];
+				if (!contains( x, y) || occupancyGrid->isBlocked( x, y))
+				{
+					continue;
+				}
+				std::uint32_t neighbour = indexOf( x, y);
+				Cost cost = entry.first + EightConnected::stepCost[i];
+				if (cost < costs[neighbour])
+				{
+					// The neighbour steps back into point
+					directions[neighbour] = static_cast< std::uint8_t >( (i + 4) % EightConnected::numberOfNeighbours);
+					push( neighbour, cost);
+				}
+			}
+		}
+		std::vector< std::pair< Cost, std::uint32_t > >().swap( queue);
+	}
+	/**
+	 *
+	 */
+	void FlowField::push(	std::uint32_t anIndex,
+							Cost aCost)
+	{
+		costs[anIndex] = aCost;
+		queue.push_back( std::make_pair( aCost, anIndex));
+		std::push_heap( queue.begin(), queue.end(), std::greater< std::pair< Cost, std::uint32_t > >());
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,196 @@
+#ifndef FLOWFIELD_HPP_
+#define FLOWFIELD_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+#include "Path.hpp"
+#include "Point.hpp"
+#include "Size.hpp"
+
+namespace Model
+{
+	struct WallChange;
+} // namespace Model
+
+namespace PathAlgorithm
+{
+	class FlowField;
+	typedef std::shared_ptr< const FlowField > FlowFieldPtr;
+
+	/**
+	 * A FlowField holds the cost to one goal and the direction of the next step towards it for every
+	 * cell of an area of the OccupancyGrid, the result of one Dijkstra search backwards from the goal
+	 * with the neighbours and costs of AStar. Any number of robots with the same free radius that drive
+	 * to the same goal follow the same field: a step is one lookup, no search per robot.
+	 *
+	 * A field is immutable and shared as the OccupancyGrid is. If the walls change, the next field is
+	 * repaired from the previous one: only the cells whose route ran through a cell that became
+	 * blocked, and the cells that can be reached cheaper through a cell that became free, are searched
+	 * again.
+	 */
+	class FlowField : private boost::noncopyable
+	{
+		public:
+			/**
+			 * The cost of a cell without a route to the goal
+			 */
+			static const Cost Unreachable = 0xFFFFFFFFu;
+			/**
+			 * Searches the field for aGoalPoint on anOccupancyGrid in the area of aWidth x aHeight cells from aTopLeft
+			 */
+			FlowField(	const Point& aGoalPoint,
+						OccupancyGridPtr anOccupancyGrid,
+						const Point& aTopLeft,
+						int aWidth,
+						int aHeight);
+			/**
+			 * Repairs aPrevious for anOccupancyGrid, the walls of aChanges changed since aPrevious was built
+			 */
+			FlowField(	const FlowField& aPrevious,
+						OccupancyGridPtr anOccupancyGrid,
+						const std::vector< Model::WallChange >& aChanges);
+			/**
+			 * Returns a shared field for aGoalPoint and the free radius of aRobotSize that covers
+			 * aStartPoint and the current walls. A field is only searched again if the walls changed,
+			 * and then repaired if the changes are known, or if aStartPoint is outside of its area.
+			 */
+			static FlowFieldPtr getFlowField(	const Point& aGoalPoint,
+												const Size& aRobotSize,
+												const Point& aStartPoint);
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= topLeft.x && anY >= topLeft.y && anX < topLeft.x + width && anY < topLeft.y + height;
+			}
+			/**
+			 *
+			 * @return The cost in pixels of the route from aPoint to the goal, infinity if there is none
+			 */
+			double getCost( const Point& aPoint) const;
+			/**
+			 *
+			 * @return The fixed point cost of the route from (anX,anY), which must be in the area, to the
+			 * 		   goal, Unreachable if there is none
+			 */
+			Cost getFixedPointCost(	int anX,
+									int anY) const
+			{
+				return costs[indexOf( anX, anY)];
+			}
+			/**
+			 * The step from aPoint towards the goal, O(1). A blocked cell, where a robot can only be if
+			 * it started there, steps to its cheapest free neighbour.
+			 *
+			 * @return false if aPoint is the goal or there is no route from aPoint
+			 */
+			bool getNext(	const Point& aPoint,
+							Point& aNext) const;
+			/**
+			 * Follows the field from aStartPoint to the goal
+			 *
+			 * @return false if there is no route, aPath is empty in that case
+			 */
+			bool getPath(	const Point& aStartPoint,
+							Path& aPath) const;
+			/**
+			 *
+			 */
+			Point getGoal() const
+			{
+				return goal;
+			}
+			/**
+			 *
+			 */
+			int getFreeRadius() const
+			{
+				return occupancyGrid->getFreeRadius();
+			}
+			/**
+			 *
+			 * @return The wall revision of the RobotWorld this field was built for
+			 */
+			unsigned long getWallRevision() const
+			{
+				return occupancyGrid->getWallRevision();
+			}
+			/**
+			 *
+			 * @return The number of cells expanded to build or repair this field
+			 */
+			unsigned long getExpansionCount() const
+			{
+				return expansionCount;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			std::uint32_t indexOf(	int anX,
+									int anY) const
+			{
+				return static_cast< std::uint32_t >( (anY - topLeft.y) * width + (anX - topLeft.x));
+			}
+			/**
+			 *
+			 */
+			Point pointOf( std::uint32_t anIndex) const
+			{
+				return Point( topLeft.x + static_cast< int >( anIndex % width), topLeft.y + static_cast< int >( anIndex / width));
+			}
+			/**
+			 * Invalidates the cells whose route runs through a cell in the area from (aLeft,aTop) to
+			 * (aRight,aBottom) that changed between anOldGrid and the grid of this field, and queues
+			 * the cells that must be searched again
+			 */
+			void repair(	const OccupancyGrid& anOldGrid,
+							int aLeft,
+							int aTop,
+							int aRight,
+							int aBottom);
+			/**
+			 * Dijkstra from the queued cells, a cost only decreases
+			 */
+			void expand();
+			/**
+			 *
+			 */
+			void push(	std::uint32_t anIndex,
+						Cost aCost);
+
+			static const std::uint8_t NoDirection = 0xFF;
+
+			Point goal;
+			OccupancyGridPtr occupancyGrid;
+			Point topLeft;
+			int width;
+			int height;
+			/**
+			 * Fixed point, see Cost, per cell in row major order
+			 */
+			std::vector< Cost > costs;
+			/**
+			 * The index in EightConnected of the step to the next cell, NoDirection for the goal and
+			 * for the cells without a route
+			 */
+			std::vector< std::uint8_t > directions;
+			unsigned long expansionCount;
+			/**
+			 * Only used while the field is built: a binary heap of the cost and the index of a cell,
+			 * with an entry for every time the cost of a cell was lowered
+			 */
+			std::vector< std::pair< Cost, std::uint32_t > > queue;
+	}; // class FlowField
+} // namespace PathAlgorithm
+#endif // FLOWFIELD_HPP_
@@ -0,0 +1,510 @@
+#include "HierarchicalPlanner.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <utility>
+#include "RobotWorld.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The cost of a cell that can not be reached inside its cluster
+	 */
+	const Cost Unreachable = std::numeric_limits< Cost >::max();
+	/**
+	 *
+	 */
+	int ClusterOf( int aCoordinate)
+	{
+		// Floor division, the clusters are aligned to absolute coordinates
+		return aCoordinate >= 0 ? aCoordinate / HierarchicalPlanner::ClusterSize : -((-aCoordinate + HierarchicalPlanner::ClusterSize - 1) / HierarchicalPlanner::ClusterSize);
+	}
+	/**
+	 *
+	 */
+	std::uint64_t ClusterKey(	int aColumn,
+								int aRow)
+	{
+		return (static_cast< std::uint64_t >( static_cast< std::uint32_t >( aColumn)) << 32) | static_cast< std::uint32_t >( aRow);
+	}
+	/**
+	 *
+	 */
+	std::uint64_t CellKey( const Point& aPoint)
+	{
+		return (static_cast< std::uint64_t >( static_cast< std::uint32_t >( aPoint.x)) << 32) | static_cast< std::uint32_t >( aPoint.y);
+	}
+	/**
+	 *
+	 */
+	Point CellOf( std::uint64_t aKey)
+	{
+		return Point( static_cast< std::int32_t >( aKey >> 32), static_cast< std::int32_t >( aKey & 0xFFFFFFFF));
+	}
+	/**
+	 *
+	 */
+	bool SameCluster(	const Point& aPoint1,
+						const Point& aPoint2)
+	{
+		return ClusterOf( aPoint1.x) == ClusterOf( aPoint2.x) && ClusterOf( aPoint1.y) == ClusterOf( aPoint2.y);
+	}
+	/**
+	 * Dijkstra from aSource to all cells of the cluster of aSource without leaving the cluster. The
+	 * neighbours and costs are those of AStar: EightConnected, StraightCost and DiagonalCost.
+	 *
+	 * @param aCosts Receives the cost per cell (row major in the cluster), Unreachable if unreachable
+	 * @param aParents Receives the predecessor per cell, -1 for the source and unreachable cells
+	 */
+	void SearchCluster(	const OccupancyGrid& anOccupancyGrid,
+						const Point& aSource,
+						std::vector< Cost >& aCosts,
+						std::vector< int >& aParents)
+	{
+		const int size = HierarchicalPlanner::ClusterSize;
+
+		Point topLeft( ClusterOf( aSource.x) * size, ClusterOf( aSource.y) * size);
+		aCosts.assign( size * size, Unreachable);
+		aParents.assign( size * size, -1);
+
+		typedef std::pair< Cost, int > QueueEntry;
+		std::priority_queue< QueueEntry, std::vector< QueueEntry >, std::greater< QueueEntry > > queue;
+
+		int source = (aSource.y - topLeft.y) * size + (aSource.x - topLeft.x);
+		aCosts[source] = 0;
+		queue.push( QueueEntry( 0, source));
+		while (!queue.empty())
+		{
+			QueueEntry entry = queue.top();
+			queue.pop();
+			if (entry.first > aCosts[entry.second])
+			{
+				continue;
+			}
+			int column = entry.second % size;
+			int row = entry.second / size;
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				int neighbourColumn = column + EightConnected::xOffset[i];
+				int neighbourRow = row + EightConnected::yOffset[i];
+				if (neighbourColumn < 0 || neighbourRow < 0 || neighbourColumn >= size || neighbourRow >= size)
+				{
+					continue;
+				}
+				if (anOccupancyGrid.isBlocked( topLeft.x + neighbourColumn, topLeft.y + neighbourRow))
+				{
+					continue;
+				}
+				int neighbour = neighbourRow * size + neighbourColumn;
+				Cost cost = entry.first + EightConnected::stepCost[i];
+				if (cost < aCosts[neighbour])
+				{
+					aCosts[neighbour] = cost;
+					aParents[neighbour] = entry.second;
+					queue.push( QueueEntry( cost, neighbour));
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 * @return The index of aPoint in the costs of SearchCluster
+	 */
+	int ClusterIndex( const Point& aPoint)
+	{
+		const int size = HierarchicalPlanner::ClusterSize;
+		return (aPoint.y - ClusterOf( aPoint.y) * size) * size + (aPoint.x - ClusterOf( aPoint.x) * size);
+	}
+	/**
+	 * Appends the cells after aFrom up to and including aTo, which must be in the same cluster, to aPath
+	 */
+	void RefineInCluster(	const OccupancyGrid& anOccupancyGrid,
+							const Point& aFrom,
+							const Point& aTo,
+							std::vector< Cost >& aCosts,
+							std::vector< int >& aParents,
+							Path& aPath)
+	{
+		SearchCluster( anOccupancyGrid, aFrom, aCosts, aParents);
+
+		const int size = HierarchicalPlanner::ClusterSize;
+		Point topLeft( ClusterOf( aFrom.x) * size, ClusterOf( aFrom.y) * size);
+		std::size_t first = aPath.size();
+		for (int cell = ClusterIndex( aTo); aParents[cell] != -1; cell = aParents[cell])
+		{
+			aPath.push_back( Point( topLeft.x + cell % size, topLeft.y + cell / size));
+		}
+		aPath.reverse( first);
+	}
+	/**
+	 *
+	 */
+	HierarchicalPlanner::HierarchicalPlanner()
+	{
+	}
+	/**
+	 *
+	 */
+	bool HierarchicalPlanner::search(	const Point& aStartPoint,
+										const Point& aGoalPoint,
+										const Size& aRobotSize,
+										Path& aPath)
+	{
+		aPath.clear();
+
+		int radius = OccupancyGrid::getFreeRadius( aRobotSize);
+		if (!clusterGraph || clusterGraph->freeRadius != radius)
+		{
+			clusterGraph = getClusterGraph( radius);
+		}
+		OccupancyGridPtr occupancyGrid = updateClusters( *clusterGraph);
+
+		if (occupancyGrid->isBlocked( aGoalPoint))
+		{
+			return false;
+		}
+
+		// As in AStar the search is bounded by the start, the goal and the inflated walls, here plus a
+		// border of one cluster
+		int left = std::min( aStartPoint.x, aGoalPoint.x);
+		int top = std::min( aStartPoint.y, aGoalPoint.y);
+		int right = std::max( aStartPoint.x, aGoalPoint.x);
+		int bottom = std::max( aStartPoint.y, aGoalPoint.y);
+		if (occupancyGrid->getWidth() > 0)
+		{
+			left = std::min( left, occupancyGrid->getOrigin().x);
+			top = std::min( top, occupancyGrid->getOrigin().y);
+			right = std::max( right, occupancyGrid->getOrigin().x + occupancyGrid->getWidth() - 1);
+			bottom = std::max( bottom, occupancyGrid->getOrigin().y + occupancyGrid->getHeight() - 1);
+		}
+		int leftCluster = ClusterOf( left) - 1;
+		int topCluster = ClusterOf( top) - 1;
+		int rightCluster = ClusterOf( right) + 1;
+		int bottomCluster = ClusterOf( bottom) + 1;
+		if (!Path::fits( leftCluster * ClusterSize, topCluster * ClusterSize, (rightCluster + 1) * ClusterSize - 1, (bottomCluster + 1) * ClusterSize - 1))
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << ", the area does not fit in a Path" << std::endl;
+			return false;
+		}
+
+		// The start and the goal are connected to the entrances of their own cluster
+		std::vector< Cost > startCosts;
+		std::vector< Cost > goalCosts;
+		std::vector< int > parents;
+		SearchCluster( *occupancyGrid, aStartPoint, startCosts, parents);
+		SearchCluster( *occupancyGrid, aGoalPoint, goalCosts, parents);
+		bool startGoalSameCluster = SameCluster( aStartPoint, aGoalPoint);
+
+		// A* on the abstract graph, the nodes are the start, the goal and the entrance cells
+		struct Node
+		{
+				Cost actualCost;
+				std::uint64_t parent;
+				bool closed;
+		};
+		std::unordered_map< std::uint64_t, Node > nodes;
+		typedef std::pair< Cost, std::uint64_t > QueueEntry;
+		std::priority_queue< QueueEntry, std::vector< QueueEntry >, std::greater< QueueEntry > > openSet;
+
+		const std::uint64_t startKey = CellKey( aStartPoint);
+		const std::uint64_t goalKey = CellKey( aGoalPoint);
+		auto heuristicCost = [&aGoalPoint](const Point& aPoint)
+		{
+			return OctileHeuristic::estimate( aPoint.x - aGoalPoint.x, aPoint.y - aGoalPoint.y);
+		};
+		auto relax = [&](	std::uint64_t aFrom,
+							const Point& aTo,
+							Cost aCost)
+		{
+			if (ClusterOf( aTo.x) < leftCluster || ClusterOf( aTo.x) > rightCluster || ClusterOf( aTo.y) < topCluster || ClusterOf( aTo.y) > bottomCluster)
+			{
+				return;
+			}
+			std::uint64_t key = CellKey( aTo);
+			std::unordered_map< std::uint64_t, Node >::iterator node = nodes.find( key);
+			if (node == nodes.end())
+			{
+				Node newNode = { aCost, aFrom, false };
+				nodes.insert( std::make_pair( key, newNode));
+			} else if (!node->second.closed && aCost < node->second.actualCost)
+			{
+				node->second.actualCost = aCost;
+				node->second.parent = aFrom;
+			} else
+			{
+				return;
+			}
+			openSet.push( QueueEntry( aCost + heuristicCost( aTo), key));
+		};
+
+		Node startNode = { 0, startKey, false };
+		nodes.insert( std::make_pair( startKey, startNode));
+		openSet.push( QueueEntry( heuristicCost( aStartPoint), startKey));
+
+		bool found = false;
+		while (!openSet.empty())
+		{
+			QueueEntry entry = openSet.top();
+			openSet.pop();
+			Node& current = nodes[entry.second];
+			if (current.closed)
+			{
+				continue;
+			}
+			current.closed = true;
+			Cost currentCost = current.actualCost;
+			if (entry.second == goalKey)
+			{
+				found = true;
+				break;
+			}
+
+			Point point = CellOf( entry.second);
+			ClusterPtr clusterPtr = getCluster( *clusterGraph, ClusterOf( point.x), ClusterOf( point.y));
+			const Cluster& cluster = *clusterPtr;
+			if (entry.second == startKey)
+			{
+				for (const Entrance& entrance : cluster.entrances)
+				{
+					Cost cost = startCosts[ClusterIndex( entrance.point)];
+					if (cost != Unreachable)
+					{
+						relax( startKey, entrance.point, cost);
+					}
+				}
+				if (startGoalSameCluster && startCosts[ClusterIndex( aGoalPoint)] != Unreachable)
+				{
+					relax( startKey, aGoalPoint, startCosts[ClusterIndex( aGoalPoint)]);
+				}
+			}
+
+			std::size_t entranceCount = cluster.entrances.size();
+			for (std::size_t i = 0; i < entranceCount; ++i)
+			{
+				if (cluster.entrances[i].point != point)
+				{
+					continue;
+				}
+				for (std::size_t j = 0; j < entranceCount; ++j)
+				{
+					Cost cost = cluster.costs[i * entranceCount + j];
+					if (j != i && cost != Unreachable)
+					{
+						relax( entry.second, cluster.entrances[j].point, currentCost + cost);
+					}
+				}
+				for (const Point& partner : cluster.entrances[i].partners)
+				{
+					relax( entry.second, partner, currentCost + StraightCost);
+				}
+				if (SameCluster( point, aGoalPoint) && goalCosts[ClusterIndex( point)] != Unreachable)
+				{
+					relax( entry.second, aGoalPoint, currentCost + goalCosts[ClusterIndex( point)]);
+				}
+			}
+		}
+
+		if (!found)
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << std::endl;
+			return false;
+		}
+
+		// Refine the abstract path: an edge inside a cluster is searched again in that cluster,
+		// an edge between two clusters is a single step across the border
+		std::vector< std::uint64_t > abstractPath;
+		for (std::uint64_t key = goalKey; key != startKey; key = nodes[key].parent)
+		{
+			abstractPath.push_back( key);
+		}
+		std::reverse( abstractPath.begin(), abstractPath.end());
+
+		aPath.push_back( aStartPoint);
+		Point previous = aStartPoint;
+		for (std::uint64_t key : abstractPath)
+		{
+			Point next = CellOf( key);
+			if (next == previous)
+			{
+				continue;
+			}
+			if (SameCluster( previous, next))
+			{
+				RefineInCluster( *occupancyGrid, previous, next, startCosts, parents, aPath);
+			} else
+			{
+				aPath.push_back( next);
+			}
+			previous = next;
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	std::size_t HierarchicalPlanner::getClusterCount() const
+	{
+		if (!clusterGraph)
+		{
+			return 0;
+		}
+		std::lock_guard< std::mutex > lock( clusterGraph->mutex);
+		return clusterGraph->clusters.size();
+	}
+	/**
+	 *
+	 */
+	/* static */HierarchicalPlanner::ClusterGraphPtr HierarchicalPlanner::getClusterGraph( int aFreeRadius)
+	{
+		static std::mutex cacheMutex;
+		static std::map< int, ClusterGraphPtr > cache;
+
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		ClusterGraphPtr& clusterGraph = cache[aFreeRadius];
+		if (!clusterGraph)
+		{
+			clusterGraph = std::make_shared< ClusterGraph >();
+			clusterGraph->freeRadius = aFreeRadius;
+			clusterGraph->wallRevision = 0;
+		}
+		return clusterGraph;
+	}
+	/**
+	 *
+	 */
+	/* static */OccupancyGridPtr HierarchicalPlanner::updateClusters( ClusterGraph& aClusterGraph)
+	{
+		OccupancyGridPtr currentGrid = OccupancyGrid::getOccupancyGrid( aClusterGraph.freeRadius);
+
+		std::lock_guard< std::mutex > lock( aClusterGraph.mutex);
+		if (aClusterGraph.occupancyGrid && currentGrid->getWallRevision() != aClusterGraph.wallRevision)
+		{
+			std::vector< Model::WallChange > changes;
+			if (!Model::RobotWorld::getRobotWorld().getWallChangesSince( aClusterGraph.wallRevision, changes))
+			{
+				aClusterGraph.clusters.clear();
+			} else
+			{
+				int freeRadius = aClusterGraph.freeRadius;
+				for (const Model::WallChange& change : changes)
+				{
+					// The cells within the free radius of the wall may have changed, a cluster
+					// next to them as well because its entrances depend on the cells across the border
+					int left = ClusterOf( std::min( change.point1.x, change.point2.x) - freeRadius - 1);
+					int right = ClusterOf( std::max( change.point1.x, change.point2.x) + freeRadius + 1);
+					int top = ClusterOf( std::min( change.point1.y, change.point2.y) - freeRadius - 1);
+					int bottom = ClusterOf( std::max( change.point1.y, change.point2.y) + freeRadius + 1);
+					for (int column = left; column <= right; ++column)
+					{
+						for (int row = top; row <= bottom; ++row)
+						{
+							aClusterGraph.clusters.erase( ClusterKey( column, row));
+						}
+					}
+				}
+			}
+		}
+		// A search that found an older grid than another one keeps the clusters of the newer walls
+		if (!aClusterGraph.occupancyGrid || currentGrid->getWallRevision() > aClusterGraph.wallRevision)
+		{
+			aClusterGraph.occupancyGrid = currentGrid;
+			aClusterGraph.wallRevision = currentGrid->getWallRevision();
+		}
+		return aClusterGraph.occupancyGrid;
+	}
+	/**
+	 *
+	 */
+	/* static */HierarchicalPlanner::ClusterPtr HierarchicalPlanner::getCluster(	ClusterGraph& aClusterGraph,
+																				int aColumn,
+																				int aRow)
+	{
+		std::lock_guard< std::mutex > lock( aClusterGraph.mutex);
+		std::unordered_map< std::uint64_t, ClusterPtr >::iterator i = aClusterGraph.clusters.find( ClusterKey( aColumn, aRow));
+		if (i != aClusterGraph.clusters.end())
+		{
+			return i->second;
+		}
+
+		const OccupancyGrid& occupancyGrid = *aClusterGraph.occupancyGrid;
+		std::shared_ptr< Cluster > cluster = std::make_shared< Cluster >();
+		int left = aColumn * ClusterSize;
+		int top = aRow * ClusterSize;
+		int right = left + ClusterSize - 1;
+		int bottom = top + ClusterSize - 1;
+		addEntrances( occupancyGrid, *cluster, Point( left, top), Point( left, top - 1), Point( 1, 0));
+		addEntrances( occupancyGrid, *cluster, Point( left, bottom), Point( left, bottom + 1), Point( 1, 0));
+		addEntrances( occupancyGrid, *cluster, Point( left, top), Point( left - 1, top), Point( 0, 1));
+		addEntrances( occupancyGrid, *cluster, Point( right, top), Point( right + 1, top), Point( 0, 1));
+
+		std::size_t entranceCount = cluster->entrances.size();
+		cluster->costs.resize( entranceCount * entranceCount);
+		std::vector< Cost > costs;
+		std::vector< int > parents;
+		for (std::size_t i = 0; i < entranceCount; ++i)
+		{
+			SearchCluster( occupancyGrid, cluster->entrances[i].point, costs, parents);
+			for (std::size_t j = 0; j < entranceCount; ++j)
+			{
+				cluster->costs[i * entranceCount + j] = costs[ClusterIndex( cluster->entrances[j].point)];
+			}
+		}
+		aClusterGraph.clusters[ClusterKey( aColumn, aRow)] = cluster;
+		return cluster;
+	}
+	/**
+	 * Both clusters at a border find the same runs of free cell pairs and choose the same cells in
+	 * them, so the entrances of adjacent clusters match without looking at each other.
+	 */
+	/* static */void HierarchicalPlanner::addEntrances(	const OccupancyGrid& anOccupancyGrid,
+														Cluster& aCluster,
+														const Point& anInside,
+														const Point& anOutside,
+														const Point& aStep)
+	{
+		// A long run gets an entrance at both ends, a short one in the middle
+		static const int shortRun = 6;
+
+		auto addEntrance = [&aCluster, &anInside, &anOutside, &aStep](int anOffset)
+		{
+			Point inside( anInside.x + anOffset * aStep.x, anInside.y + anOffset * aStep.y);
+			Point outside( anOutside.x + anOffset * aStep.x, anOutside.y + anOffset * aStep.y);
+			for (Entrance& entrance : aCluster.entrances)
+			{
+				if (entrance.point == inside)
+				{
+					entrance.partners.push_back( outside);
+					return;
+				}
+			}
+			Entrance entrance = { inside, std::vector< Point >( 1, outside) };
+			aCluster.entrances.push_back( entrance);
+		};
+
+		int runBegin = -1;
+		for (int offset = 0; offset <= ClusterSize; ++offset)
+		{
+			bool free = offset < ClusterSize &&
+						!anOccupancyGrid.isBlocked( anInside.x + offset * aStep.x, anInside.y + offset * aStep.y) &&
+						!anOccupancyGrid.isBlocked( anOutside.x + offset * aStep.x, anOutside.y + offset * aStep.y);
+			if (free && runBegin == -1)
+			{
+				runBegin = offset;
+			} else if (!free && runBegin != -1)
+			{
+				int runEnd = offset - 1;
+				if (runEnd - runBegin + 1 < shortRun)
+				{
+					addEntrance( (runBegin + runEnd) / 2);
+				} else
+				{
+					addEntrance( runBegin);
+					addEntrance( runEnd);
+				}
+				runBegin = -1;
+			}
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,125 @@
+#ifndef HIERARCHICALPLANNER_HPP_
+#define HIERARCHICALPLANNER_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+#include "Point.hpp"
+#include "Size.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The HierarchicalPlanner is a HPA* planner on the OccupancyGrid. The grid is divided in square
+	 * clusters of ClusterSize cells. Where the free cells on both sides of the border between two
+	 * clusters form a run, one or two entrances are placed in it, and the cost of the shortest
+	 * path inside a cluster between each pair of its entrances is calculated once.
+	 *
+	 * A search connects the start and the goal to the entrances of their clusters, searches the
+	 * abstract graph of entrances and refines every abstract edge to cells inside one cluster.
+	 * The paths are near optimal: a path crosses a border only at an entrance.
+	 *
+	 * The clusters are built lazily and shared by all HierarchicalPlanners that search for the same
+	 * free radius, as the OccupancyGrid is. If the walls change, only the clusters near the changed
+	 * walls are thrown away, see RobotWorld::getWallChangesSince. The costs are the fixed point Costs
+	 * of AStar.
+	 */
+	class HierarchicalPlanner : private boost::noncopyable
+	{
+		public:
+			/**
+			 *
+			 */
+			static const int ClusterSize = 32;
+			/**
+			 *
+			 */
+			HierarchicalPlanner();
+			/**
+			 *
+			 * @param aPath Receives the path from aStartPoint to aGoalPoint, its buffer is reused
+			 * @return false if there is no route, aPath is empty in that case
+			 */
+			bool search(	const Point& aStartPoint,
+							const Point& aGoalPoint,
+							const Size& aRobotSize,
+							Path& aPath);
+			/**
+			 *
+			 * @return The number of clusters that are currently cached for the free radius of the last search
+			 */
+			std::size_t getClusterCount() const;
+
+		private:
+			/**
+			 * A cell at the border of a cluster and its free neighbours in the adjacent clusters
+			 */
+			struct Entrance
+			{
+					Point point;
+					std::vector< Point > partners;
+			};
+			/**
+			 * A cluster does not change once it is built, a search keeps using it if it is thrown away
+			 */
+			struct Cluster
+			{
+					std::vector< Entrance > entrances;
+					/**
+					 * The cost between entrance i and j is costs[i * entrances.size() + j]
+					 */
+					std::vector< Cost > costs;
+			};
+			typedef std::shared_ptr< const Cluster > ClusterPtr;
+			/**
+			 * The clusters of one free radius
+			 */
+			struct ClusterGraph
+			{
+					int freeRadius;
+					OccupancyGridPtr occupancyGrid;
+					unsigned long wallRevision;
+					std::unordered_map< std::uint64_t, ClusterPtr > clusters;
+					std::mutex mutex;
+			};
+			typedef std::shared_ptr< ClusterGraph > ClusterGraphPtr;
+			/**
+			 *
+			 * @return The clusters for aFreeRadius, shared by all HierarchicalPlanners
+			 */
+			static ClusterGraphPtr getClusterGraph( int aFreeRadius);
+			/**
+			 * Throws away the clusters of aClusterGraph that are affected by the walls changed since they
+			 * were built
+			 *
+			 * @return The OccupancyGrid of the current walls
+			 */
+			static OccupancyGridPtr updateClusters( ClusterGraph& aClusterGraph);
+			/**
+			 *
+			 * @return The cluster of aClusterGraph, it is built if needed
+			 */
+			static ClusterPtr getCluster(	ClusterGraph& aClusterGraph,
+											int aColumn,
+											int aRow);
+			/**
+			 *
+			 */
+			static void addEntrances(	const OccupancyGrid& anOccupancyGrid,
+										Cluster& aCluster,
+										const Point& anInside,
+										const Point& anOutside,
+										const Point& aStep);
+
+			ClusterGraphPtr clusterGraph;
+	}; // class HierarchicalPlanner
+} // namespace PathAlgorithm
+#endif // HIERARCHICALPLANNER_HPP_
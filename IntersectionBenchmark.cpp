@@ -0,0 +1,78 @@
+#include "IntersectionBenchmark.hpp"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include "Shape2DUtils.hpp"
+
+namespace Application
+{
+	/**
+	 *
+	 */
+	IntersectionBenchmark::IntersectionBenchmark() :
+								AbstractBenchmark( "intersection", { 10, 1000, 100000 })
+	{
+	}
+	/**
+	 *
+	 */
+	void IntersectionBenchmark::runSize(	int aSize,
+											std::mt19937& aRandom,
+											std::ostream& aLog)
+	{
+		const unsigned long numberOfTests = 20000000;
+
+		int numberOfWalls = aSize;
+		std::uniform_int_distribution< int > coordinate( 0, 1000);
+		std::uniform_int_distribution< int > wallOffset( -100, 100);
+		std::uniform_int_distribution< int > sideOffset( -30, 30);
+
+		std::vector< std::pair< Point, Point > > walls;
+		Utils::Segments wallLines;
+		wallLines.reserve( static_cast< std::size_t >( numberOfWalls));
+		for (int i = 0; i < numberOfWalls; ++i)
+		{
+			Point point1( coordinate( aRandom), coordinate( aRandom));
+			Point point2( point1.x + wallOffset( aRandom), point1.y + wallOffset( aRandom));
+			walls.push_back( std::make_pair( point1, point2));
+			wallLines.push_back( point1, point2);
+		}
+		std::vector< std::pair< Point, Point > > sides;
+		for (unsigned long i = 0; i < std::max( 1ul, numberOfTests / static_cast< unsigned long >( numberOfWalls)); ++i)
+		{
+			Point start( coordinate( aRandom), coordinate( aRandom));
+			sides.push_back( std::make_pair( start, Point( start.x + sideOffset( aRandom), start.y + sideOffset( aRandom))));
+		}
+
+		std::size_t scalarHits = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (const std::pair< Point, Point >& side : sides)
+		{
+			for (const std::pair< Point, Point >& wall : walls)
+			{
+				if (Utils::Shape2DUtils::intersect( side.first, side.second, wall.first, wall.second))
+				{
+					++scalarHits;
+				}
+			}
+		}
+		std::chrono::steady_clock::duration scalarDuration = std::chrono::steady_clock::now() - start;
+
+		std::vector< std::size_t > indices;
+		start = std::chrono::steady_clock::now();
+		for (const std::pair< Point, Point >& side : sides)
+		{
+			Utils::Shape2DUtils::intersect( side.first, side.second, wallLines, indices);
+		}
+		std::chrono::steady_clock::duration batchDuration = std::chrono::steady_clock::now() - start;
+
+		double tests = static_cast< double >( sides.size()) * walls.size();
+		double scalarNanoseconds = std::chrono::duration< double, std::nano >( scalarDuration).count() / tests;
+		double batchNanoseconds = std::chrono::duration< double, std::nano >( batchDuration).count() / tests;
+		aLog << numberOfWalls << " walls, " << sides.size() << " lines: "
+			 << scalarNanoseconds << " ns per test scalar, "
+			 << batchNanoseconds << " ns per test batched, "
+			 << scalarNanoseconds / batchNanoseconds << "x, "
+			 << scalarHits << " and " << indices.size() << " intersections";
+	}
+} // namespace Application
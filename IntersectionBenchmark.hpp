@@ -0,0 +1,34 @@
+#ifndef INTERSECTIONBENCHMARK_HPP_
+#define INTERSECTIONBENCHMARK_HPP_
+
+#include "Config.hpp"
+
+#include "AbstractBenchmark.hpp"
+
+namespace Application
+{
+	/**
+	 * Compares the batched Shape2DUtils::intersect with a loop over the single segment version for 10,
+	 * 1k and 100k random walls in a 1000 by 1000 world. Every query line is a side of a robot, about 30
+	 * pixels long, and is tested against all walls; the number of queries shrinks as the number of
+	 * walls grows so every run does about the same number of tests.
+	 */
+	class IntersectionBenchmark : public AbstractBenchmark
+	{
+		public:
+			/**
+			 *
+			 */
+			IntersectionBenchmark();
+
+		protected:
+			/**
+			 *
+			 */
+			virtual void runSize(	int aSize,
+									std::mt19937& aRandom,
+									std::ostream& aLog);
+	};
+	//	class IntersectionBenchmark
+} // namespace Application
+#endif // INTERSECTIONBENCHMARK_HPP_
@@ -0,0 +1,162 @@
+#include "Landmarks.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	/* static */std::mutex Landmarks::cacheMutex;
+	/**
+	 *
+	 */
+	/* static */std::map< int, Landmarks::CacheEntry > Landmarks::cache;
+	/**
+	 *
+	 */
+	Landmarks::Landmarks(	OccupancyGridPtr anOccupancyGrid,
+							const Point& aTopLeft,
+							int aWidth,
+							int aHeight,
+							int aNumberOfLandmarks) :
+								occupancyGrid( anOccupancyGrid),
+								topLeft( aTopLeft),
+								width( aWidth),
+								height( aHeight)
+	{
+		// The landmarks are spread clockwise over the border of the area, from the top left corner.
+		// The border is outside of the inflated walls and therefore free.
+		int perimeter = 2 * (width - 1) + 2 * (height - 1);
+		for (int i = 0; i < aNumberOfLandmarks; ++i)
+		{
+			int offset = static_cast< int >( static_cast< long long >( i) * perimeter / aNumberOfLandmarks);
+			Point landmark;
+			if (offset < width - 1)
+			{
+				landmark = Point( topLeft.x + offset, topLeft.y);
+			} else if (offset < width - 1 + height - 1)
+			{
+				landmark = Point( topLeft.x + width - 1, topLeft.y + offset - (width - 1));
+			} else if (offset < 2 * (width - 1) + height - 1)
+			{
+				landmark = Point( topLeft.x + width - 1 - (offset - (width - 1) - (height - 1)), topLeft.y + height - 1);
+			} else
+			{
+				landmark = Point( topLeft.x, topLeft.y + height - 1 - (offset - 2 * (width - 1) - (height - 1)));
+			}
+			if (!occupancyGrid->isBlocked( landmark))
+			{
+				landmarks.push_back( landmark);
+			}
+		}
+
+		std::vector< std::future< FlowFieldPtr > > searches;
+		for (const Point& landmark : landmarks)
+		{
+			searches.push_back( std::async( std::launch::async, [this, landmark]
+			{
+				return std::make_shared< const FlowField >( landmark, occupancyGrid, topLeft, width, height);
+			}));
+		}
+		for (std::future< FlowFieldPtr >& search : searches)
+		{
+			tables.push_back( search.get());
+		}
+	}
+	/**
+	 *
+	 */
+	/* static */LandmarksPtr Landmarks::getLandmarks(	int aFreeRadius,
+														const Point& aStartPoint,
+														const Point& aGoalPoint)
+	{
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( aFreeRadius);
+
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		CacheEntry& entry = cache[aFreeRadius];
+		if (entry.refresh.valid() && entry.refresh.wait_for( std::chrono::seconds( 0)) == std::future_status::ready)
+		{
+			entry.current = entry.refresh.get();
+		}
+		if (entry.current && entry.current->getWallRevision() == occupancyGrid->getWallRevision() &&
+			entry.current->contains( aStartPoint.x, aStartPoint.y) && entry.current->contains( aGoalPoint.x, aGoalPoint.y))
+		{
+			return entry.current;
+		}
+
+		if (!entry.refresh.valid())
+		{
+			// The new area holds the old one as well, so that the tables are not rebuilt for every
+			// search between other points
+			int left = std::min( aStartPoint.x, aGoalPoint.x);
+			int top = std::min( aStartPoint.y, aGoalPoint.y);
+			int right = std::max( aStartPoint.x, aGoalPoint.x);
+			int bottom = std::max( aStartPoint.y, aGoalPoint.y);
+			addWalls( *occupancyGrid, left, top, right, bottom);
+			if (entry.current)
+			{
+				left = std::min( left, entry.current->topLeft.x + 1);
+				top = std::min( top, entry.current->topLeft.y + 1);
+				right = std::max( right, entry.current->topLeft.x + entry.current->width - 2);
+				bottom = std::max( bottom, entry.current->topLeft.y + entry.current->height - 2);
+			}
+			int numberOfLandmarks = entry.numberOfLandmarks;
+			entry.refresh = std::async( std::launch::async, [occupancyGrid, left, top, right, bottom, numberOfLandmarks]
+			{
+				return std::make_shared< const Landmarks >( occupancyGrid, Point( left - 1, top - 1), right - left + 3, bottom - top + 3, numberOfLandmarks);
+			});
+		}
+		return LandmarksPtr();
+	}
+	/**
+	 *
+	 */
+	/* static */LandmarksPtr Landmarks::precompute(	int aFreeRadius,
+													const Point& aPoint,
+													int aNumberOfLandmarks /*= DefaultNumberOfLandmarks*/)
+	{
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( aFreeRadius);
+		int left = aPoint.x;
+		int top = aPoint.y;
+		int right = aPoint.x;
+		int bottom = aPoint.y;
+		addWalls( *occupancyGrid, left, top, right, bottom);
+		LandmarksPtr landmarks = std::make_shared< const Landmarks >( occupancyGrid, Point( left - 1, top - 1), right - left + 3, bottom - top + 3, aNumberOfLandmarks);
+
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		CacheEntry& entry = cache[aFreeRadius];
+		entry.current = landmarks;
+		entry.numberOfLandmarks = aNumberOfLandmarks;
+		return landmarks;
+	}
+	/**
+	 *
+	 */
+	/* static */void Landmarks::addWalls(	const OccupancyGrid& anOccupancyGrid,
+											int& aLeft,
+											int& aTop,
+											int& aRight,
+											int& aBottom)
+	{
+		if (anOccupancyGrid.getWidth() > 0)
+		{
+			aLeft = std::min( aLeft, anOccupancyGrid.getOrigin().x);
+			aTop = std::min( aTop, anOccupancyGrid.getOrigin().y);
+			aRight = std::max( aRight, anOccupancyGrid.getOrigin().x + anOccupancyGrid.getWidth() - 1);
+			aBottom = std::max( aBottom, anOccupancyGrid.getOrigin().y + anOccupancyGrid.getHeight() - 1);
+		}
+	}
+	/**
+	 *
+	 */
+	void Landmarks::getDistances(	const Point& aPoint,
+									std::vector< Cost >& aDistances) const
+	{
+		aDistances.clear();
+		for (const FlowFieldPtr& table : tables)
+		{
+			aDistances.push_back( contains( aPoint.x, aPoint.y) ? table->getFixedPointCost( aPoint.x, aPoint.y) : FlowField::Unreachable);
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,168 @@
+#ifndef LANDMARKS_HPP_
+#define LANDMARKS_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "AStar.hpp"
+#include "FlowField.hpp"
+#include "OccupancyGrid.hpp"
+#include "Point.hpp"
+
+namespace PathAlgorithm
+{
+	class Landmarks;
+	typedef std::shared_ptr< const Landmarks > LandmarksPtr;
+
+	/**
+	 * Landmarks are the distance tables of the ALT heuristic (A*, landmarks and the triangle
+	 * inequality, Goldberg and Harrison). For a few landmark cells the cost from every cell of an area
+	 * to the landmark is searched once, in parallel, as the FlowField of the landmark. By the triangle
+	 * inequality the cost from a cell to a goal is at least the difference of their costs to any
+	 * landmark. Behind a wall that bound is close to the cost of the route around it, where the octile
+	 * distance only sees the straight line, so AStar expands far fewer cells.
+	 *
+	 * The landmarks are spread evenly over the border of the area, around the walls. The tables are
+	 * immutable and shared, and are built again in the background when the walls change; tables for
+	 * old walls are never used, the bound would not hold if a wall was removed.
+	 */
+	class Landmarks : private boost::noncopyable
+	{
+		public:
+			/**
+			 *
+			 */
+			static const int DefaultNumberOfLandmarks = 8;
+			/**
+			 * Searches the tables of aNumberOfLandmarks landmarks in the area of aWidth x aHeight cells
+			 * from aTopLeft, each in its own thread
+			 */
+			Landmarks(	OccupancyGridPtr anOccupancyGrid,
+						const Point& aTopLeft,
+						int aWidth,
+						int aHeight,
+						int aNumberOfLandmarks);
+			/**
+			 * Returns the tables for the free radius and the current walls if their area holds both
+			 * points. If there are none, new tables are built in the background and nullptr is returned:
+			 * a search does not wait for them and uses its own heuristic.
+			 */
+			static LandmarksPtr getLandmarks(	int aFreeRadius,
+												const Point& aStartPoint,
+												const Point& aGoalPoint);
+			/**
+			 * Builds the tables for the free radius and the current walls now, for an area that holds
+			 * aPoint, and waits for them
+			 */
+			static LandmarksPtr precompute(	int aFreeRadius,
+											const Point& aPoint,
+											int aNumberOfLandmarks = DefaultNumberOfLandmarks);
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= topLeft.x && anY >= topLeft.y && anX < topLeft.x + width && anY < topLeft.y + height;
+			}
+			/**
+			 *
+			 * @param aDistances Receives the cost from aPoint to every landmark, the argument of estimate
+			 */
+			void getDistances(	const Point& aPoint,
+								std::vector< Cost >& aDistances) const;
+			/**
+			 * The lower bound on the cost from (anX,anY) to the point of aGoalDistances
+			 *
+			 * @return The largest difference of the costs to a landmark, 0 if (anX,anY) is outside of the area
+			 */
+			Cost estimate(	int anX,
+							int anY,
+							const std::vector< Cost >& aGoalDistances) const
+			{
+				if (!contains( anX, anY))
+				{
+					return 0;
+				}
+				Cost bound = 0;
+				for (std::size_t i = 0; i < tables.size(); ++i)
+				{
+					Cost distance = tables[i]->getFixedPointCost( anX, anY);
+					Cost goalDistance = aGoalDistances[i];
+					if (distance == FlowField::Unreachable || goalDistance == FlowField::Unreachable)
+					{
+						continue;
+					}
+					Cost difference = distance > goalDistance ? distance - goalDistance : goalDistance - distance;
+					if (difference > bound)
+					{
+						bound = difference;
+					}
+				}
+				return bound;
+			}
+			/**
+			 *
+			 * @return The wall revision of the RobotWorld the tables were built for
+			 */
+			unsigned long getWallRevision() const
+			{
+				return occupancyGrid->getWallRevision();
+			}
+			/**
+			 *
+			 */
+			const std::vector< Point >& getLandmarkPoints() const
+			{
+				return landmarks;
+			}
+
+		private:
+			/**
+			 * The tables of one free radius: the current ones and the ones that are being built
+			 */
+			struct CacheEntry
+			{
+					CacheEntry() :
+						numberOfLandmarks( DefaultNumberOfLandmarks)
+					{
+					}
+
+					LandmarksPtr current;
+					std::future< LandmarksPtr > refresh;
+					int numberOfLandmarks;
+			};
+			/**
+			 * Grows the area from (aLeft,aTop) to (aRight,aBottom) to hold the inflated walls of anOccupancyGrid
+			 */
+			static void addWalls(	const OccupancyGrid& anOccupancyGrid,
+									int& aLeft,
+									int& aTop,
+									int& aRight,
+									int& aBottom);
+
+			static std::mutex cacheMutex;
+			/**
+			 * The tables by free radius
+			 */
+			static std::map< int, CacheEntry > cache;
+
+			OccupancyGridPtr occupancyGrid;
+			Point topLeft;
+			int width;
+			int height;
+			std::vector< Point > landmarks;
+			/**
+			 * The table of landmarks[i]
+			 */
+			std::vector< FlowFieldPtr > tables;
+	}; // class Landmarks
+} // namespace PathAlgorithm
+#endif // LANDMARKS_HPP_
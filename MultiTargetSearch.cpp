@@ -0,0 +1,257 @@
+#include "MultiTargetSearch.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	MultiTargetSearch::MultiTargetSearch() :
+								cancellationFlag( nullptr),
+								expansionCount( 0),
+								reverse( false),
+								openSet( searchGrid)
+	{
+	}
+	/**
+	 *
+	 */
+	void MultiTargetSearch::setCancellationFlag( const std::atomic< bool >* aFlag)
+	{
+		cancellationFlag = aFlag;
+	}
+	/**
+	 *
+	 */
+	std::size_t MultiTargetSearch::searchFrom(	const Point& aStartPoint,
+												const std::vector< Point >& aTargets,
+												const Size& aRobotSize)
+	{
+		reverse = false;
+		return search( aStartPoint, aTargets, aRobotSize);
+	}
+	/**
+	 *
+	 */
+	std::size_t MultiTargetSearch::searchTo(	const std::vector< Point >& aSources,
+												const Point& aGoalPoint,
+												const Size& aRobotSize)
+	{
+		reverse = true;
+		return search( aGoalPoint, aSources, aRobotSize);
+	}
+	/**
+	 *
+	 */
+	bool MultiTargetSearch::isReached( std::size_t anIndex) const
+	{
+		return anIndex < pointCells.size() && searchGrid.getState( pointCells[anIndex]) == SearchGrid::Closed;
+	}
+	/**
+	 *
+	 */
+	double MultiTargetSearch::getCost( std::size_t anIndex) const
+	{
+		if (!isReached( anIndex))
+		{
+			return std::numeric_limits< double >::infinity();
+		}
+		return static_cast< double >( searchGrid.getActualCost( pointCells[anIndex])) / StraightCost;
+	}
+	/**
+	 *
+	 */
+	std::size_t MultiTargetSearch::getNearest() const
+	{
+		std::size_t nearest = NoPoint;
+		for (std::size_t i = 0; i < pointCells.size(); ++i)
+		{
+			if (isReached( i) && (nearest == NoPoint || searchGrid.getActualCost( pointCells[i]) < searchGrid.getActualCost( pointCells[nearest])))
+			{
+				nearest = i;
+			}
+		}
+		return nearest;
+	}
+	/**
+	 *
+	 */
+	bool MultiTargetSearch::getPath(	std::size_t anIndex,
+										Path& aPath) const
+	{
+		aPath.clear();
+		if (!isReached( anIndex))
+		{
+			return false;
+		}
+		for (std::uint32_t node = pointCells[anIndex]; node != SearchGrid::NoCell; node = searchGrid.getParent( node))
+		{
+			aPath.push_back( searchGrid.pointOf( node));
+		}
+		// The predecessors point towards the root, which is the start of searchFrom and the goal of searchTo
+		if (!reverse)
+		{
+			aPath.reverse();
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	std::size_t MultiTargetSearch::search(	const Point& aRoot,
+											const std::vector< Point >& aPoints,
+											const Size& aRobotSize)
+	{
+		OccupancyGridPtr occupancyGrid = OccupancyGrid::getOccupancyGrid( OccupancyGrid::getFreeRadius( aRobotSize));
+
+		// The area of the search as in AStar, for all points
+		int left = aRoot.x;
+		int top = aRoot.y;
+		int right = aRoot.x;
+		int bottom = aRoot.y;
+		for (const Point& point : aPoints)
+		{
+			left = std::min( left, point.x);
+			top = std::min( top, point.y);
+			right = std::max( right, point.x);
+			bottom = std::max( bottom, point.y);
+		}
+		if (occupancyGrid->getWidth() > 0)
+		{
+			left = std::min( left, occupancyGrid->getOrigin().x);
+			top = std::min( top, occupancyGrid->getOrigin().y);
+			right = std::max( right, occupancyGrid->getOrigin().x + occupancyGrid->getWidth() - 1);
+			bottom = std::max( bottom, occupancyGrid->getOrigin().y + occupancyGrid->getHeight() - 1);
+		}
+		openSet.clear();
+		expansionCount = 0;
+
+		pointCells.clear();
+		remainingCells.clear();
+		if (!Path::fits( left - 1, top - 1, right + 1, bottom + 1))
+		{
+			// No point is reached, the routes could not be stored in a Path
+			std::cerr << "**** No route from " << aRoot << ", the area does not fit in a Path" << std::endl;
+			return 0;
+		}
+		searchGrid.reset( Point( left - 1, top - 1), right - left + 3, bottom - top + 3);
+		for (const Point& point : aPoints)
+		{
+			pointCells.push_back( searchGrid.indexOf( point.x, point.y));
+			if (!occupancyGrid->isBlocked( point))
+			{
+				remainingCells.push_back( pointCells.back());
+			}
+		}
+		std::sort( remainingCells.begin(), remainingCells.end());
+		remainingCells.erase( std::unique( remainingCells.begin(), remainingCells.end()), remainingCells.end());
+		remainingPoints.clear();
+		for (std::uint32_t cell : remainingCells)
+		{
+			remainingPoints.push_back( searchGrid.pointOf( cell));
+		}
+
+		std::uint32_t rootIndex = searchGrid.indexOf( aRoot.x, aRoot.y);
+		SearchGrid::Cell rootCell = searchGrid.at( rootIndex);
+		rootCell.actualCost = 0;
+		rootCell.parent = SearchGrid::NoCell;
+		openSet.push( rootIndex, estimate( rootIndex), 0);
+
+		while (!openSet.empty() && !remainingCells.empty())
+		{
+			std::uint32_t currentIndex = openSet.top();
+			openSet.pop();
+			SearchGrid::Cell currentCell = searchGrid.at( currentIndex);
+			currentCell.state = SearchGrid::Closed;
+
+			std::vector< std::uint32_t >::iterator remaining = std::lower_bound( remainingCells.begin(), remainingCells.end(), currentIndex);
+			if (remaining != remainingCells.end() && *remaining == currentIndex)
+			{
+				removeRemaining( remaining);
+			}
+
+			++expansionCount;
+			if ((expansionCount & 0x3F) == 0 && cancellationFlag != nullptr && cancellationFlag->load( std::memory_order_relaxed))
+			{
+				break;
+			}
+
+			Point current = searchGrid.pointOf( currentIndex);
+			for (int i = 0; i < EightConnected::numberOfNeighbours; ++i)
+			{
+				int x = current.x + EightConnected::xOffset[i];
+				int y = current.y + EightConnected::yOffset[i];
+				if (!searchGrid.contains( x, y) || occupancyGrid->isBlocked( x, y))
+				{
+					continue;
+				}
+				Cost cost = currentCell.actualCost + EightConnected::stepCost[i];
+				std::uint32_t neighbourIndex = searchGrid.indexOf( x, y);
+				SearchGrid::Cell neighbourCell = searchGrid.at( neighbourIndex);
+				// The heuristic is consistent, a closed cell has its lowest cost
+				if (neighbourCell.state == SearchGrid::Closed || (neighbourCell.state == SearchGrid::Open && neighbourCell.actualCost <= cost))
+				{
+					continue;
+				}
+				neighbourCell.actualCost = cost;
+				neighbourCell.parent = currentIndex;
+				if (neighbourCell.state == SearchGrid::Open)
+				{
+					openSet.update( neighbourIndex, estimate( neighbourIndex), cost);
+				} else
+				{
+					openSet.push( neighbourIndex, estimate( neighbourIndex), cost);
+				}
+			}
+		}
+
+		std::size_t reached = 0;
+		for (std::size_t i = 0; i < pointCells.size(); ++i)
+		{
+			if (isReached( i))
+			{
+				++reached;
+			}
+		}
+		return reached;
+	}
+	/**
+	 *
+	 */
+	Cost MultiTargetSearch::estimate( std::uint32_t anIndex) const
+	{
+		Point point = searchGrid.pointOf( anIndex);
+		Cost nearest = 0;
+		for (std::size_t i = 0; i < remainingPoints.size(); ++i)
+		{
+			Cost distance = OctileHeuristic::estimate( remainingPoints[i].x - point.x, remainingPoints[i].y - point.y);
+			if (i == 0 || distance < nearest)
+			{
+				nearest = distance;
+			}
+		}
+		return searchGrid.getActualCost( anIndex) + nearest;
+	}
+	/**
+	 *
+	 */
+	void MultiTargetSearch::removeRemaining( std::vector< std::uint32_t >::iterator aRemaining)
+	{
+		remainingPoints.erase( remainingPoints.begin() + (aRemaining - remainingCells.begin()));
+		remainingCells.erase( aRemaining);
+		if (remainingCells.empty())
+		{
+			return;
+		}
+
+		// The heuristic of an open cell can only grow, its key must be recalculated
+		std::vector< std::uint32_t > open( openSet.begin(), openSet.end());
+		openSet.clear();
+		for (std::uint32_t index : open)
+		{
+			openSet.push( index, estimate( index), searchGrid.getActualCost( index));
+		}
+	}
+} // namespace PathAlgorithm
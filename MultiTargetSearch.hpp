@@ -0,0 +1,141 @@
+#ifndef MULTITARGETSEARCH_HPP_
+#define MULTITARGETSEARCH_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "AStar.hpp"
+#include "OccupancyGrid.hpp"
+#include "Path.hpp"
+#include "Point.hpp"
+#include "SearchGrid.hpp"
+#include "Size.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * MultiTargetSearch is a Dijkstra search on the OccupancyGrid with the neighbours and costs of AStar
+	 * that finds the routes between one point and a set of points in one expansion, where AStar needs a
+	 * search per pair. The search is guided by the octile distance to the nearest point that is not
+	 * reached yet, which is a consistent heuristic for the whole set, so it expands the cells towards
+	 * the points first and stops as soon as all points are reached. The open cells get the heuristic of
+	 * the remaining points every time a point is reached.
+	 *
+	 * - searchFrom finds the routes from one start to many targets, e.g. to pick the nearest of
+	 *   several goals;
+	 * - searchTo finds the routes from many sources to one target. The grid is undirected, so this is a
+	 *   search from the target whose predecessors point towards it.
+	 *
+	 * The paths are not built by the search: getPath follows the predecessors of one point only when
+	 * it is asked for, until the next search. The costs between all waypoints of a tour therefore take
+	 * one search per waypoint instead of one per pair.
+	 */
+	class MultiTargetSearch : private boost::noncopyable
+	{
+		public:
+			/**
+			 * The index returned by getNearest if no point was reached
+			 */
+			static const std::size_t NoPoint = static_cast< std::size_t >( -1);
+			/**
+			 *
+			 */
+			MultiTargetSearch();
+			/**
+			 * As AStar::setCancellationFlag
+			 */
+			void setCancellationFlag( const std::atomic< bool >* aFlag);
+			/**
+			 * Searches the routes from aStartPoint to all of aTargets
+			 *
+			 * @return The number of targets that can be reached
+			 */
+			std::size_t searchFrom(	const Point& aStartPoint,
+									const std::vector< Point >& aTargets,
+									const Size& aRobotSize);
+			/**
+			 * Searches the routes from all of aSources to aGoalPoint
+			 *
+			 * @return The number of sources from which aGoalPoint can be reached
+			 */
+			std::size_t searchTo(	const std::vector< Point >& aSources,
+									const Point& aGoalPoint,
+									const Size& aRobotSize);
+			/**
+			 *
+			 * @return true if there is a route between the root and the target or source anIndex
+			 */
+			bool isReached( std::size_t anIndex) const;
+			/**
+			 *
+			 * @return The cost in pixels of the route between the root and the target or source anIndex,
+			 * 		   infinity if there is none
+			 */
+			double getCost( std::size_t anIndex) const;
+			/**
+			 *
+			 * @return The index of the target or source with the cheapest route, NoPoint if none is reached
+			 */
+			std::size_t getNearest() const;
+			/**
+			 * Builds the route of the last search from the start to target anIndex (searchFrom) or from
+			 * source anIndex to the goal (searchTo)
+			 *
+			 * @return false if there is no route, aPath is empty in that case
+			 */
+			bool getPath(	std::size_t anIndex,
+							Path& aPath) const;
+			/**
+			 *
+			 * @return The number of cells expanded by the last search
+			 */
+			unsigned long getExpansionCount() const
+			{
+				return expansionCount;
+			}
+
+		private:
+			/**
+			 * The search from aRoot until all cells of aPoints are closed
+			 */
+			std::size_t search(	const Point& aRoot,
+								const std::vector< Point >& aPoints,
+								const Size& aRobotSize);
+			/**
+			 *
+			 * @return The cost of the cell plus the octile distance to the nearest remaining point
+			 */
+			Cost estimate( std::uint32_t anIndex) const;
+			/**
+			 * Removes a reached cell from the remaining cells and gives the open cells the heuristic of
+			 * the remaining points
+			 */
+			void removeRemaining( std::vector< std::uint32_t >::iterator aRemaining);
+
+			const std::atomic< bool >* cancellationFlag;
+			unsigned long expansionCount;
+			/**
+			 * true if the last search was searchTo: the paths follow the predecessors from the source
+			 */
+			bool reverse;
+			/**
+			 * The cell of every target or source, in the order of the arguments of the search
+			 */
+			std::vector< std::uint32_t > pointCells;
+			/**
+			 * The distinct cells of pointCells that are not reached yet, sorted
+			 */
+			std::vector< std::uint32_t > remainingCells;
+			/**
+			 * The points of remainingCells
+			 */
+			std::vector< Point > remainingPoints;
+			SearchGrid searchGrid;
+			OpenSet openSet;
+	}; // class MultiTargetSearch
+} // namespace PathAlgorithm
+#endif // MULTITARGETSEARCH_HPP_
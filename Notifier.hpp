@@ -75,6 +75,14 @@ namespace Base
 			 * Notifies all observers
 			 */
 			virtual void notifyObservers();
+			/**
+			 *
+			 * @return True if there is at least one Observer
+			 */
+			bool hasObservers() const
+			{
+				return !observers.empty();
+			}
 			//@}
 
 			/**
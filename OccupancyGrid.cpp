@@ -0,0 +1,156 @@
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <mutex>
+#include "RobotWorld.hpp"
+#include "Wall.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	OccupancyGrid::OccupancyGrid( int aFreeRadius) :
+								freeRadius( aFreeRadius),
+								wallRevision( Model::RobotWorld::getRobotWorld().getWallRevision()),
+								origin( 0, 0),
+								width( 0),
+								height( 0)
+	{
+		// Copy the end points under the lock of the walls first, the GUI edits the walls while we are
+		// rasterising. The revision is read before the copy so a concurrent edit results in a rebuild next time.
+		std::vector< std::pair< Point, Point > > lines;
+		Model::RobotWorld::getRobotWorld().getWallLines( lines);
+		if (lines.empty())
+		{
+			return;
+		}
+
+		int minX = std::numeric_limits< int >::max();
+		int minY = std::numeric_limits< int >::max();
+		int maxX = std::numeric_limits< int >::min();
+		int maxY = std::numeric_limits< int >::min();
+		for (const std::pair< Point, Point >& line : lines)
+		{
+			minX = std::min( minX, std::min( line.first.x, line.second.x));
+			minY = std::min( minY, std::min( line.first.y, line.second.y));
+			maxX = std::max( maxX, std::max( line.first.x, line.second.x));
+			maxY = std::max( maxY, std::max( line.first.y, line.second.y));
+		}
+		origin = Point( minX - freeRadius, minY - freeRadius);
+		width = maxX - minX + 2 * freeRadius + 1;
+		height = maxY - minY + 2 * freeRadius + 1;
+		cells.assign( static_cast< std::size_t >( width) * height, 0);
+
+		for (const std::pair< Point, Point >& line : lines)
+		{
+			rasterise( line.first, line.second);
+		}
+	}
+	/**
+	 *
+	 */
+	/* static */OccupancyGridPtr OccupancyGrid::getOccupancyGrid( int aFreeRadius)
+	{
+		static std::mutex cacheMutex;
+		static std::map< int, OccupancyGridPtr > cache;
+
+		unsigned long wallRevision = Model::RobotWorld::getRobotWorld().getWallRevision();
+
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		OccupancyGridPtr& grid = cache[aFreeRadius];
+		if (!grid || grid->getWallRevision() != wallRevision)
+		{
+			grid = std::make_shared< const OccupancyGrid >( aFreeRadius);
+		}
+		return grid;
+	}
+	/**
+	 *
+	 */
+	/* static */int OccupancyGrid::getFreeRadius( const Size& aRobotSize)
+	{
+		return std::sqrt( (aRobotSize.x / 2.0) * (aRobotSize.x / 2.0) + (aRobotSize.y / 2.0) * (aRobotSize.y / 2.0));
+	}
+	/**
+	 *
+	 */
+	bool OccupancyGrid::isLineFree(	const Point& aPoint1,
+									const Point& aPoint2) const
+	{
+		// Nothing is blocked outside of the grid
+		if (width == 0 ||
+			std::max( aPoint1.x, aPoint2.x) < origin.x || std::min( aPoint1.x, aPoint2.x) >= origin.x + width ||
+			std::max( aPoint1.y, aPoint2.y) < origin.y || std::min( aPoint1.y, aPoint2.y) >= origin.y + height)
+		{
+			return true;
+		}
+
+		// Bresenham
+		int dx = std::abs( aPoint2.x - aPoint1.x);
+		int dy = -std::abs( aPoint2.y - aPoint1.y);
+		int stepX = aPoint1.x < aPoint2.x ? 1 : -1;
+		int stepY = aPoint1.y < aPoint2.y ? 1 : -1;
+		int error = dx + dy;
+		int x = aPoint1.x;
+		int y = aPoint1.y;
+		for (;;)
+		{
+			if (isBlocked( x, y))
+			{
+				return false;
+			}
+			if (x == aPoint2.x && y == aPoint2.y)
+			{
+				return true;
+			}
+			int doubleError = 2 * error;
+			if (doubleError >= dy)
+			{
+				error += dy;
+				x += stepX;
+			}
+			if (doubleError <= dx)
+			{
+				error += dx;
+				y += stepY;
+			}
+		}
+	}
+	/**
+	 * This is Utils::Shape2DUtils::isOnLine for all cells in the bounding box of the line at once,
+	 * with the length of the line calculated only once.
+	 */
+	void OccupancyGrid::rasterise( 	const Point& aPoint1,
+									const Point& aPoint2)
+	{
+		double normalLength = std::sqrt( (aPoint1.x - aPoint2.x) * (aPoint1.x - aPoint2.x) + (aPoint1.y - aPoint2.y) * (aPoint1.y - aPoint2.y));
+		if (normalLength == 0.0)
+		{
+			// isOnLine never reports a point on a line without length
+			return;
+		}
+		double maxCross = freeRadius * normalLength;
+
+		int left = std::min( aPoint1.x, aPoint2.x) - freeRadius;
+		int right = std::max( aPoint1.x, aPoint2.x) + freeRadius;
+		int top = std::min( aPoint1.y, aPoint2.y) - freeRadius;
+		int bottom = std::max( aPoint1.y, aPoint2.y) + freeRadius;
+
+		for (int y = top; y <= bottom; ++y)
+		{
+			std::uint8_t* row = &cells[static_cast< std::size_t >( y - origin.y) * width];
+			for (int x = left; x <= right; ++x)
+			{
+				int cross = std::abs( (x - aPoint2.x) * (aPoint1.y - aPoint2.y) - (y - aPoint2.y) * (aPoint1.x - aPoint2.x));
+				if (cross < maxCross)
+				{
+					row[x - origin.x] = 1;
+				}
+			}
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,128 @@
+#ifndef OCCUPANCYGRID_HPP_
+#define OCCUPANCYGRID_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Point.hpp"
+#include "Size.hpp"
+
+namespace PathAlgorithm
+{
+	class OccupancyGrid;
+	typedef std::shared_ptr< const OccupancyGrid > OccupancyGridPtr;
+
+	/**
+	 * The OccupancyGrid is the configuration space of a robot: all walls of the RobotWorld rasterised
+	 * into one byte per pixel cell, inflated by the free radius of the robot. A cell is blocked if it
+	 * is within the free radius of a wall as defined by Utils::Shape2DUtils::isOnLine.
+	 *
+	 * The grid only covers the bounding box of the inflated walls, everything outside of it is free.
+	 */
+	class OccupancyGrid
+	{
+		public:
+			/**
+			 * Rasterises the current walls of the RobotWorld
+			 *
+			 * @param aFreeRadius The number of pixels a cell must be away from any wall to be free
+			 */
+			explicit OccupancyGrid( int aFreeRadius);
+			/**
+			 * Returns a shared, immutable grid for the current walls and the given radius. The grid
+			 * is only rebuilt if the wall revision of the RobotWorld has changed since it was built.
+			 */
+			static OccupancyGridPtr getOccupancyGrid( int aFreeRadius);
+			/**
+			 *
+			 * @return The free radius of a robot of aRobotSize: half its diagonal
+			 */
+			static int getFreeRadius( const Size& aRobotSize);
+			/**
+			 *
+			 * @return true if a robot with the free radius of this grid can not be at (anX,anY)
+			 */
+			bool isBlocked( 	int anX,
+								int anY) const
+			{
+				int column = anX - origin.x;
+				int row = anY - origin.y;
+				if (column < 0 || row < 0 || column >= width || row >= height)
+				{
+					return false;
+				}
+				return cells[static_cast< std::size_t >( row) * width + column] != 0;
+			}
+			/**
+			 *
+			 */
+			bool isBlocked( const Point& aPoint) const
+			{
+				return isBlocked( aPoint.x, aPoint.y);
+			}
+			/**
+			 * A robot with the free radius of this grid can drive in a straight line from aPoint1 to
+			 * aPoint2 if all cells of the 8-connected line between them are free, as AStar allows a
+			 * diagonal step between two blocked cells as well.
+			 *
+			 * @return true if no cell on the line from aPoint1 to aPoint2 is blocked
+			 */
+			bool isLineFree(	const Point& aPoint1,
+								const Point& aPoint2) const;
+			/**
+			 *
+			 */
+			int getFreeRadius() const
+			{
+				return freeRadius;
+			}
+			/**
+			 *
+			 * @return The wall revision of the RobotWorld this grid was built for
+			 */
+			unsigned long getWallRevision() const
+			{
+				return wallRevision;
+			}
+			/**
+			 *
+			 * @return The top left cell of the area that may contain blocked cells
+			 */
+			Point getOrigin() const
+			{
+				return origin;
+			}
+			/**
+			 *
+			 */
+			int getWidth() const
+			{
+				return width;
+			}
+			/**
+			 *
+			 */
+			int getHeight() const
+			{
+				return height;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			void rasterise( 	const Point& aPoint1,
+								const Point& aPoint2);
+
+			int freeRadius;
+			unsigned long wallRevision;
+			Point origin;
+			int width;
+			int height;
+			std::vector< std::uint8_t > cells;
+	}; // class OccupancyGrid
+} // namespace PathAlgorithm
+#endif // OCCUPANCYGRID_HPP_
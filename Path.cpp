@@ -0,0 +1,63 @@
+#include "Path.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	void Path::push_back( const Point& aPoint)
+	{
+		if (aPoint.x < std::numeric_limits< std::int16_t >::min() || aPoint.x > std::numeric_limits< std::int16_t >::max() ||
+			aPoint.y < std::numeric_limits< std::int16_t >::min() || aPoint.y > std::numeric_limits< std::int16_t >::max())
+		{
+			throw std::out_of_range( "Path::push_back: point does not fit in 16 bits");
+		}
+		points.push_back( static_cast< std::uint16_t >( aPoint.x) | static_cast< std::uint32_t >( static_cast< std::uint16_t >( aPoint.y)) << 16);
+	}
+	/**
+	 *
+	 */
+	void Path::reverse( std::size_t aFirst /*= 0*/)
+	{
+		std::reverse( points.begin() + static_cast< std::ptrdiff_t >( aFirst), points.end());
+	}
+	/**
+	 *
+	 */
+	void Path::truncate( std::size_t aSize)
+	{
+		if (aSize < points.size())
+		{
+			points.erase( points.begin() + static_cast< std::ptrdiff_t >( aSize), points.end());
+		}
+	}
+	/**
+	 *
+	 */
+	double Path::getLength() const
+	{
+		double length = 0.0;
+		for (std::size_t i = 1; i < points.size(); ++i)
+		{
+			Point from = unpack( points[i - 1]);
+			Point to = unpack( points[i]);
+			length += std::sqrt( static_cast< double >( (to.x - from.x) * (to.x - from.x) + (to.y - from.y) * (to.y - from.y)));
+		}
+		return length;
+	}
+	/**
+	 *
+	 */
+	/* static */bool Path::fits(	int aLeft,
+								int aTop,
+								int aRight,
+								int aBottom)
+	{
+		return aLeft >= std::numeric_limits< std::int16_t >::min() && aTop >= std::numeric_limits< std::int16_t >::min() &&
+				aRight <= std::numeric_limits< std::int16_t >::max() && aBottom <= std::numeric_limits< std::int16_t >::max();
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,175 @@
+#ifndef PATH_HPP_
+#define PATH_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "Point.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * A Path is the sequence of points of a route, one per cell or the end points of straight
+	 * segments. The points are packed as pairs of 16 bit coordinates, 4 bytes per point, so a path
+	 * costs a sixth of the memory of a vector of Vertex. The coordinates must fit in a std::int16_t.
+	 *
+	 * The points are read by value: a Path can not be changed in place, only appended to.
+	 */
+	class Path
+	{
+		public:
+			/**
+			 *
+			 */
+			class const_iterator
+			{
+				public:
+					typedef std::forward_iterator_tag iterator_category;
+					typedef Point value_type;
+					typedef std::ptrdiff_t difference_type;
+					typedef const Point* pointer;
+					typedef Point reference;
+
+					explicit const_iterator( std::vector< std::uint32_t >::const_iterator anIterator) :
+						iterator( anIterator)
+					{
+					}
+					Point operator*() const
+					{
+						return unpack( *iterator);
+					}
+					const_iterator& operator++()
+					{
+						++iterator;
+						return *this;
+					}
+					bool operator==( const const_iterator& anIterator) const
+					{
+						return iterator == anIterator.iterator;
+					}
+					bool operator!=( const const_iterator& anIterator) const
+					{
+						return iterator != anIterator.iterator;
+					}
+
+				private:
+					std::vector< std::uint32_t >::const_iterator iterator;
+			};
+			/**
+			 *
+			 */
+			bool empty() const
+			{
+				return points.empty();
+			}
+			/**
+			 *
+			 */
+			std::size_t size() const
+			{
+				return points.size();
+			}
+			/**
+			 *
+			 */
+			Point operator[]( std::size_t anIndex) const
+			{
+				return unpack( points[anIndex]);
+			}
+			/**
+			 *
+			 */
+			Point front() const
+			{
+				return unpack( points.front());
+			}
+			/**
+			 *
+			 */
+			Point back() const
+			{
+				return unpack( points.back());
+			}
+			/**
+			 *
+			 */
+			const_iterator begin() const
+			{
+				return const_iterator( points.begin());
+			}
+			/**
+			 *
+			 */
+			const_iterator end() const
+			{
+				return const_iterator( points.end());
+			}
+			/**
+			 * A planner checks its search area with fits before it searches and gives no route for an
+			 * area that does not fit, push_back is never asked to store a point outside it
+			 *
+			 * @throw std::out_of_range if a coordinate of aPoint does not fit in 16 bits
+			 */
+			void push_back( const Point& aPoint);
+			/**
+			 * Reverses the points from aFirst to the end, a planner that follows the predecessors
+			 * from the goal appends the path backwards
+			 */
+			void reverse( std::size_t aFirst = 0);
+			/**
+			 * Removes the points from aSize to the end
+			 */
+			void truncate( std::size_t aSize);
+			/**
+			 *
+			 */
+			void clear()
+			{
+				points.clear();
+			}
+			/**
+			 *
+			 */
+			void reserve( std::size_t aSize)
+			{
+				points.reserve( aSize);
+			}
+			/**
+			 *
+			 */
+			void swap( Path& aPath)
+			{
+				points.swap( aPath.points);
+			}
+			/**
+			 *
+			 * @return The length of the path in pixels, the sum of the lengths of its segments
+			 */
+			double getLength() const;
+			/**
+			 *
+			 * @return true if every point of the rectangle from (aLeft,aTop) to (aRight,aBottom) fits in
+			 * 			a Path
+			 */
+			static bool fits(	int aLeft,
+								int aTop,
+								int aRight,
+								int aBottom);
+
+		private:
+			/**
+			 *
+			 */
+			static Point unpack( std::uint32_t aPoint)
+			{
+				return Point( static_cast< std::int16_t >( aPoint & 0xFFFF), static_cast< std::int16_t >( aPoint >> 16));
+			}
+
+			std::vector< std::uint32_t > points;
+	}; // class Path
+} // namespace PathAlgorithm
+#endif // PATH_HPP_
@@ -0,0 +1,115 @@
+#include "PathCache.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	std::size_t PathCache::KeyHash::operator()( const Key& aKey) const
+	{
+		std::size_t hash = static_cast< std::size_t >( aKey.freeRadius) * 4 + aKey.strategy;
+		for (int value : { aKey.start.x, aKey.start.y, aKey.goal.x, aKey.goal.y })
+		{
+			hash = hash * 31 + static_cast< std::size_t >( value);
+		}
+		return hash;
+	}
+	/**
+	 *
+	 */
+	PathCache::PathCache( std::size_t aCapacity) :
+								capacity( aCapacity),
+								wallRevision( 0),
+								hits( 0),
+								misses( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	bool PathCache::find(	const Point& aStart,
+							const Point& aGoal,
+							int aFreeRadius,
+							AStar::Strategy aStrategy,
+							unsigned long aWallRevision,
+							Path& aPath)
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		updateRevision( aWallRevision);
+
+		Key key = { aStart, aGoal, aFreeRadius, aStrategy };
+		std::unordered_map< Key, Entries::iterator, KeyHash >::iterator i = index.find( key);
+		if (i == index.end() || aWallRevision != wallRevision)
+		{
+			++misses;
+			return false;
+		}
+		entries.splice( entries.begin(), entries, i->second);
+		aPath = i->second->second;
+		++hits;
+		return true;
+	}
+	/**
+	 *
+	 */
+	void PathCache::insert(	const Point& aStart,
+							const Point& aGoal,
+							int aFreeRadius,
+							AStar::Strategy aStrategy,
+							unsigned long aWallRevision,
+							const Path& aPath)
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		updateRevision( aWallRevision);
+		if (aWallRevision != wallRevision || capacity == 0)
+		{
+			// Planned for walls that have changed already
+			return;
+		}
+
+		Key key = { aStart, aGoal, aFreeRadius, aStrategy };
+		std::unordered_map< Key, Entries::iterator, KeyHash >::iterator i = index.find( key);
+		if (i != index.end())
+		{
+			i->second->second = aPath;
+			entries.splice( entries.begin(), entries, i->second);
+			return;
+		}
+		if (entries.size() == capacity)
+		{
+			index.erase( entries.back().first);
+			entries.pop_back();
+		}
+		entries.push_front( std::make_pair( key, aPath));
+		index[key] = entries.begin();
+	}
+	/**
+	 *
+	 */
+	void PathCache::clear()
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		entries.clear();
+		index.clear();
+	}
+	/**
+	 *
+	 */
+	std::size_t PathCache::size() const
+	{
+		std::lock_guard< std::mutex > lock( cacheMutex);
+		return entries.size();
+	}
+	/**
+	 *
+	 */
+	void PathCache::updateRevision( unsigned long aWallRevision)
+	{
+		if (aWallRevision > wallRevision)
+		{
+			entries.clear();
+			index.clear();
+			wallRevision = aWallRevision;
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,119 @@
+#ifndef PATHCACHE_HPP_
+#define PATHCACHE_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <boost/noncopyable.hpp>
+
+#include "AStar.hpp"
+#include "Point.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The PathCache keeps the most recently planned paths, keyed by start cell, goal cell, free radius
+	 * and AStar::Strategy, for one wall revision of the RobotWorld. When a lookup or an insert is done for a newer
+	 * revision all paths are thrown away, a path is never returned for walls it was not planned for.
+	 *
+	 * The cache is bounded: if it is full the least recently used path is replaced. It is safe to
+	 * use from several threads.
+	 */
+	class PathCache : private boost::noncopyable
+	{
+		public:
+			/**
+			 *
+			 * @param aCapacity The maximum number of paths
+			 */
+			explicit PathCache( std::size_t aCapacity);
+			/**
+			 *
+			 * @param aPath Receives a copy of the cached path if there is one
+			 * @return true on a hit
+			 */
+			bool find(	const Point& aStart,
+						const Point& aGoal,
+						int aFreeRadius,
+						AStar::Strategy aStrategy,
+						unsigned long aWallRevision,
+						Path& aPath);
+			/**
+			 * Caches aPath, which was planned for aWallRevision
+			 */
+			void insert(	const Point& aStart,
+							const Point& aGoal,
+							int aFreeRadius,
+							AStar::Strategy aStrategy,
+							unsigned long aWallRevision,
+							const Path& aPath);
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 *
+			 */
+			std::size_t size() const;
+			/**
+			 *
+			 */
+			unsigned long getHits() const
+			{
+				return hits;
+			}
+			/**
+			 *
+			 */
+			unsigned long getMisses() const
+			{
+				return misses;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			struct Key
+			{
+					Point start;
+					Point goal;
+					int freeRadius;
+					AStar::Strategy strategy;
+
+					bool operator==( const Key& aKey) const
+					{
+						return start == aKey.start && goal == aKey.goal && freeRadius == aKey.freeRadius && strategy == aKey.strategy;
+					}
+			};
+			/**
+			 *
+			 */
+			struct KeyHash
+			{
+					std::size_t operator()( const Key& aKey) const;
+			};
+			typedef std::list< std::pair< Key, Path > > Entries;
+			/**
+			 * Throws the paths away if aWallRevision is newer than the revision of the paths
+			 */
+			void updateRevision( unsigned long aWallRevision);
+
+			std::size_t capacity;
+			unsigned long wallRevision;
+			/**
+			 * Most recently used first
+			 */
+			Entries entries;
+			std::unordered_map< Key, Entries::iterator, KeyHash > index;
+			mutable std::mutex cacheMutex;
+
+			std::atomic< unsigned long > hits;
+			std::atomic< unsigned long > misses;
+	}; // class PathCache
+} // namespace PathAlgorithm
+#endif // PATHCACHE_HPP_
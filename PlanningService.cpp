@@ -0,0 +1,212 @@
+#include "PlanningService.hpp"
+#include <algorithm>
+#include "OccupancyGrid.hpp"
+#include "RobotWorld.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	Plan::Plan(	const PlanRequest& aRequest,
+				std::function< void( const PlanResult&) > aCallback) :
+								request( aRequest),
+								callback( aCallback),
+								result( promise.get_future()),
+								cancelled( false),
+								planner( nullptr)
+	{
+	}
+	/**
+	 *
+	 */
+	void Plan::cancel()
+	{
+		cancelled = true;
+	}
+	/**
+	 *
+	 */
+	OpenSetSnapshot Plan::getOpenSet() const
+	{
+		return std::atomic_load( &openSet);
+	}
+	/**
+	 *
+	 */
+	void Plan::handleNotification()
+	{
+		// Called on the worker thread during the search, the planner is valid
+		std::atomic_store( &openSet, planner->getOpenSet());
+		notifyObservers();
+	}
+	/**
+	 *
+	 */
+	void Plan::execute(	AStar& aPlanner,
+						AnytimeAStar& anAnytimePlanner,
+						PathCache& aPathCache)
+	{
+		try
+		{
+			PlanResult planResult;
+			planResult.outcome = AStar::Cancelled;
+			planResult.bound = 1.0;
+
+			// The revision is read before the search: if the walls change during the search the path is
+			// cached for the old revision and is thrown away by the next lookup
+			unsigned long wallRevision = Model::RobotWorld::getRobotWorld().getWallRevision();
+			int freeRadius = OccupancyGrid::getFreeRadius( request.robotSize);
+			if (!cancelled && aPathCache.find( request.start, request.goal, freeRadius, request.strategy, wallRevision, planResult.path))
+			{
+				planResult.outcome = AStar::Found;
+			} else if (!cancelled && request.weight > 1.0)
+			{
+				anAnytimePlanner.setWeights( request.weight, 0.5);
+				anAnytimePlanner.setTimeBudget( request.timeBudget);
+				anAnytimePlanner.setCancellationFlag( &cancelled);
+				anAnytimePlanner.search( request.start, request.goal, request.robotSize, planResult.path);
+				anAnytimePlanner.setCancellationFlag( nullptr);
+
+				planResult.outcome = anAnytimePlanner.getOutcome();
+				planResult.bound = anAnytimePlanner.getBound();
+				// Only optimal routes are cached, they are the answer to any request
+				if (planResult.outcome == AStar::Found && planResult.bound == 1.0)
+				{
+					aPathCache.insert( request.start, request.goal, freeRadius, request.strategy, wallRevision, planResult.path);
+				}
+			} else if (!cancelled)
+			{
+				aPlanner.setStrategy( request.strategy);
+				aPlanner.setTimeBudget( request.timeBudget);
+				aPlanner.setUseLandmarks( request.landmarks);
+				aPlanner.setProgressInterval( request.progressExpansions, request.progressInterval);
+				aPlanner.setCancellationFlag( &cancelled);
+
+				planner = &aPlanner;
+				handleNotificationsFor( aPlanner);
+				aPlanner.search( request.start, request.goal, request.robotSize, planResult.path);
+				stopHandlingNotificationsFor( aPlanner);
+				planner = nullptr;
+
+				aPlanner.setCancellationFlag( nullptr);
+				planResult.outcome = aPlanner.getOutcome();
+				if (planResult.outcome == AStar::Found)
+				{
+					aPathCache.insert( request.start, request.goal, freeRadius, request.strategy, wallRevision, planResult.path);
+				}
+			}
+			if (callback)
+			{
+				callback( planResult);
+			}
+			promise.set_value( std::move( planResult));
+		}
+		catch (...)
+		{
+			// A failed search leaves the planners as a cancelled one would, the worker goes on with the
+			// next Plan and get() of the future throws the exception
+			stopHandlingNotificationsFor( aPlanner);
+			planner = nullptr;
+			aPlanner.setCancellationFlag( nullptr);
+			anAnytimePlanner.setCancellationFlag( nullptr);
+			promise.set_exception( std::current_exception());
+		}
+	}
+	/**
+	 *
+	 */
+	/* static */PlanningService& PlanningService::getPlanningService()
+	{
+		static PlanningService planningService( std::max( 1u, std::thread::hardware_concurrency()));
+		return planningService;
+	}
+	/**
+	 *
+	 */
+	PlanningService::PlanningService( unsigned int aNumberOfWorkers) :
+								pathCache( 256),
+								stopping( false)
+	{
+		for (unsigned int i = 0; i < aNumberOfWorkers; ++i)
+		{
+			workers.push_back( std::thread( [this]{	work();}));
+		}
+	}
+	/**
+	 *
+	 */
+	PlanningService::~PlanningService()
+	{
+		{
+			std::lock_guard< std::mutex > lock( queueMutex);
+			stopping = true;
+			for (PlanPtr plan : queue)
+			{
+				plan->cancel();
+			}
+			for (PlanPtr plan : running)
+			{
+				plan->cancel();
+			}
+		}
+		queueChanged.notify_all();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	}
+	/**
+	 *
+	 */
+	PlanPtr PlanningService::submit(	const PlanRequest& aRequest,
+										std::function< void( const PlanResult&) > aCallback /*= nullptr*/)
+	{
+		PlanPtr plan = std::make_shared< Plan >( aRequest, aCallback);
+		submit( plan);
+		return plan;
+	}
+	/**
+	 *
+	 */
+	void PlanningService::submit( PlanPtr aPlan)
+	{
+		{
+			std::lock_guard< std::mutex > lock( queueMutex);
+			queue.push_back( aPlan);
+		}
+		queueChanged.notify_one();
+	}
+	/**
+	 *
+	 */
+	void PlanningService::work()
+	{
+		// Every worker keeps its own planners and with them the search grid of their previous search
+		AStar planner;
+		AnytimeAStar anytimePlanner;
+		for (;;)
+		{
+			PlanPtr plan;
+			{
+				std::unique_lock< std::mutex > lock( queueMutex);
+				while (queue.empty() && !stopping)
+				{
+					queueChanged.wait( lock);
+				}
+				if (queue.empty())
+				{
+					return;
+				}
+				plan = queue.front();
+				queue.pop_front();
+				running.push_back( plan);
+			}
+
+			plan->execute( planner, anytimePlanner, pathCache);
+
+			std::lock_guard< std::mutex > lock( queueMutex);
+			running.erase( std::find( running.begin(), running.end(), plan));
+		}
+	}
+} // namespace PathAlgorithm
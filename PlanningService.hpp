@@ -0,0 +1,227 @@
+#ifndef PLANNINGSERVICE_HPP_
+#define PLANNINGSERVICE_HPP_
+
+#include "Config.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "AStar.hpp"
+#include "AnytimeAStar.hpp"
+#include "Notifier.hpp"
+#include "Observer.hpp"
+#include "PathCache.hpp"
+#include "Point.hpp"
+#include "Size.hpp"
+#include "Thread.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	struct PlanRequest
+	{
+			/**
+			 *
+			 */
+			PlanRequest(	const Point& aStart,
+							const Point& aGoal,
+							const Size& aRobotSize) :
+								start( aStart),
+								goal( aGoal),
+								robotSize( aRobotSize),
+								strategy( AStar::Standard),
+								weight( 1.0),
+								timeBudget( 0),
+								progressExpansions( 0),
+								progressInterval( 0),
+								landmarks( false)
+			{
+			}
+
+			Point start;
+			Point goal;
+			Size robotSize;
+			AStar::Strategy strategy;
+			/**
+			 * 1 searches the optimal route with AStar and the strategy. A higher weight searches with
+			 * AnytimeAStar, starting with this weight, and returns the best route found within the
+			 * time budget.
+			 */
+			double weight;
+			/**
+			 * The maximum duration of the search, 0 is no limit
+			 */
+			std::chrono::milliseconds timeBudget;
+			/**
+			 * The intervals of the progress notifications of the Plan in expanded vertices and in time,
+			 * see AStar::setProgressInterval. Both 0 is none.
+			 */
+			unsigned long progressExpansions;
+			std::chrono::milliseconds progressInterval;
+			/**
+			 * true if AStar uses the Landmarks of the robot size as well, see AStar::setUseLandmarks
+			 */
+			bool landmarks;
+	};
+	/**
+	 *
+	 */
+	struct PlanResult
+	{
+			Path path;
+			AStar::Outcome outcome;
+			/**
+			 * The cost of the path is at most bound times the optimal cost
+			 */
+			double bound;
+	};
+	/**
+	 * A Plan is a PlanRequest submitted to the PlanningService. It is the handle of the submitter:
+	 * its result is a future, it can be cancelled and it notifies its observers of the progress of
+	 * the search with a snapshot of the open set, as AStar does.
+	 */
+	class Plan :	public Base::Notifier,
+					public Base::Observer,
+					private boost::noncopyable
+	{
+		public:
+			/**
+			 *
+			 */
+			Plan(	const PlanRequest& aRequest,
+					std::function< void( const PlanResult&) > aCallback);
+			/**
+			 *
+			 */
+			const PlanRequest& getRequest() const
+			{
+				return request;
+			}
+			/**
+			 * The future is valid until its result has been taken with get(), which throws the
+			 * exception of a search that failed
+			 */
+			std::future< PlanResult >& getResult()
+			{
+				return result;
+			}
+			/**
+			 * Stops the search as soon as possible, the outcome is AStar::Cancelled. A Plan that has
+			 * not started yet is not searched at all.
+			 */
+			void cancel();
+			/**
+			 *
+			 */
+			bool isCancelled() const
+			{
+				return cancelled;
+			}
+			/**
+			 *
+			 * @return The open set at the last progress notification, nullptr if there was none
+			 */
+			OpenSetSnapshot getOpenSet() const;
+			/**
+			 * Forwards the progress notifications of the AStar that searches this Plan
+			 */
+			virtual void handleNotification();
+
+		private:
+			friend class PlanningService;
+			/**
+			 * Takes the path from aPathCache or searches the Plan with aPlanner or, if the request has
+			 * a weight, with anAnytimePlanner. Called by a worker of the PlanningService. Does not throw:
+			 * an exception of the search is delivered through the future.
+			 */
+			void execute(	AStar& aPlanner,
+							AnytimeAStar& anAnytimePlanner,
+							PathCache& aPathCache);
+
+			PlanRequest request;
+			std::function< void( const PlanResult&) > callback;
+			std::promise< PlanResult > promise;
+			std::future< PlanResult > result;
+			std::atomic< bool > cancelled;
+			/**
+			 * The AStar that is searching this Plan, only valid during execute
+			 */
+			const AStar* planner;
+			/**
+			 * Only accessed with std::atomic_load and std::atomic_store
+			 */
+			OpenSetSnapshot openSet;
+	}; // class Plan
+	typedef std::shared_ptr< Plan > PlanPtr;
+
+	/**
+	 * The PlanningService searches the submitted Plans on a pool of worker threads, each with its
+	 * own AStar and AnytimeAStar, so that a robot does not block on a search and several robots plan concurrently.
+	 */
+	class PlanningService : private boost::noncopyable
+	{
+		public:
+			/**
+			 * The service shared by all robots, with one worker per core
+			 */
+			static PlanningService& getPlanningService();
+			/**
+			 *
+			 */
+			explicit PlanningService( unsigned int aNumberOfWorkers);
+			/**
+			 * Cancels all Plans and waits for the workers to finish
+			 */
+			~PlanningService();
+			/**
+			 * Queues a request for the next free worker
+			 *
+			 * @param aCallback Called by the worker with the result before the future becomes ready,
+			 * 					may be empty
+			 * @return The Plan, its result is delivered through its future
+			 */
+			PlanPtr submit(	const PlanRequest& aRequest,
+							std::function< void( const PlanResult&) > aCallback = nullptr);
+			/**
+			 * Queues a Plan that was made by the caller, for example to observe it before it starts
+			 */
+			void submit( PlanPtr aPlan);
+			/**
+			 *
+			 */
+			unsigned int getNumberOfWorkers() const
+			{
+				return static_cast< unsigned int >( workers.size());
+			}
+			/**
+			 * The paths found by the workers, shared by all robots
+			 */
+			PathCache& getPathCache()
+			{
+				return pathCache;
+			}
+
+		private:
+			/**
+			 * The loop of a worker thread
+			 */
+			void work();
+
+			PathCache pathCache;
+			std::mutex queueMutex;
+			std::condition_variable queueChanged;
+			std::deque< PlanPtr > queue;
+			std::vector< PlanPtr > running;
+			bool stopping;
+			std::vector< std::thread > workers;
+	}; // class PlanningService
+} // namespace PathAlgorithm
+#endif // PLANNINGSERVICE_HPP_
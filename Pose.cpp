@@ -0,0 +1,166 @@
+#include "Pose.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Model
+{
+	/**
+	 *
+	 */
+	Pose::Pose() :
+				cornerX{ 0.0, 0.0, 0.0, 0.0 },
+				cornerY{ 0.0, 0.0, 0.0, 0.0 },
+				axisX( 1.0),
+				axisY( 0.0)
+	{
+	}
+	/**
+	 *
+	 */
+	Pose::Pose(	const Point& aPosition,
+				const Size& aSize)
+	{
+		setCorners( aPosition, aSize, 1.0, 0.0);
+	}
+	/**
+	 * The box is turned a quarter more than the angle of aFront, the front side is perpendicular to
+	 * it. The cosine and sine of that angle follow from the normalised front without any trigonometry.
+	 */
+	Pose::Pose(	const Point& aPosition,
+				const Size& aSize,
+				const BoundedVector& aFront)
+	{
+		double length = std::sqrt( static_cast< double >( aFront.x) * aFront.x + static_cast< double >( aFront.y) * aFront.y);
+		if (length > 0.0)
+		{
+			setCorners( aPosition, aSize, -aFront.y / length, aFront.x / length);
+		} else
+		{
+			setCorners( aPosition, aSize, 0.0, 1.0);
+		}
+	}
+	/**
+	 *
+	 */
+	void Pose::getBounds(	double& aLeft,
+							double& aTop,
+							double& aRight,
+							double& aBottom) const
+	{
+		aLeft = std::min( std::min( cornerX[0], cornerX[1]), std::min( cornerX[2], cornerX[3]));
+		aTop = std::min( std::min( cornerY[0], cornerY[1]), std::min( cornerY[2], cornerY[3]));
+		aRight = std::max( std::max( cornerX[0], cornerX[1]), std::max( cornerX[2], cornerX[3]));
+		aBottom = std::max( std::max( cornerY[0], cornerY[1]), std::max( cornerY[2], cornerY[3]));
+	}
+	/**
+	 *
+	 */
+	bool Pose::intersects( const Pose& aPose) const
+	{
+		const double axes[][2] = { { axisX, axisY }, { -axisY, axisX }, { aPose.axisX, aPose.axisY }, { -aPose.axisY, aPose.axisX } };
+		for (const double* axis : axes)
+		{
+			double minimum = aPose.cornerX[0] * axis[0] + aPose.cornerY[0] * axis[1];
+			double maximum = minimum;
+			for (int i = 1; i < 4; ++i)
+			{
+				double projection = aPose.cornerX[i] * axis[0] + aPose.cornerY[i] * axis[1];
+				minimum = std::min( minimum, projection);
+				maximum = std::max( maximum, projection);
+			}
+			if (separates( axis[0], axis[1], minimum, maximum))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	bool Pose::intersects(	const Point& aPoint1,
+							const Point& aPoint2) const
+	{
+		const double axes[][2] = { { axisX, axisY }, { -axisY, axisX }, { static_cast< double >( aPoint1.y - aPoint2.y), static_cast< double >( aPoint2.x - aPoint1.x) } };
+		for (const double* axis : axes)
+		{
+			double projection1 = aPoint1.x * axis[0] + aPoint1.y * axis[1];
+			double projection2 = aPoint2.x * axis[0] + aPoint2.y * axis[1];
+			if (separates( axis[0], axis[1], std::min( projection1, projection2), std::max( projection1, projection2)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	/**
+	 * The edges of the swept box are the edges of the box and the two lines along aTranslation that
+	 * join its corners, so the axes to test are those of the box, the normal of aTranslation and the
+	 * normal of the line.
+	 */
+	bool Pose::intersects(	const Point& aPoint1,
+							const Point& aPoint2,
+							const Point& aTranslation) const
+	{
+		const double axes[][2] = { { axisX, axisY },
+								   { -axisY, axisX },
+								   { static_cast< double >( -aTranslation.y), static_cast< double >( aTranslation.x) },
+								   { static_cast< double >( aPoint1.y - aPoint2.y), static_cast< double >( aPoint2.x - aPoint1.x) } };
+		for (const double* axis : axes)
+		{
+			double projection1 = aPoint1.x * axis[0] + aPoint1.y * axis[1];
+			double projection2 = aPoint2.x * axis[0] + aPoint2.y * axis[1];
+			if (separates( axis[0], axis[1], std::min( projection1, projection2), std::max( projection1, projection2), aTranslation))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	/**
+	 * With an odd size the centre lies half a pixel before the middle, as the shapes draw it
+	 */
+	void Pose::setCorners(	const Point& aPosition,
+							const Size& aSize,
+							double aCos,
+							double aSin)
+	{
+		const double left = -(aSize.x / 2);
+		const double right = aSize.x - aSize.x / 2;
+		const double front = -(aSize.y / 2);
+		const double back = aSize.y - aSize.y / 2;
+
+		const double offsetX[] = { right, left, left, right };
+		const double offsetY[] = { front, front, back, back };
+		for (int i = 0; i < 4; ++i)
+		{
+			cornerX[i] = offsetX[i] * aCos - offsetY[i] * aSin + aPosition.x;
+			cornerY[i] = offsetY[i] * aCos + offsetX[i] * aSin + aPosition.y;
+		}
+		axisX = aCos;
+		axisY = aSin;
+	}
+	/**
+	 *
+	 */
+	bool Pose::separates(	double anAxisX,
+							double anAxisY,
+							double aMinimum,
+							double aMaximum,
+							const Point& aTranslation /*= Point( 0, 0)*/) const
+	{
+		double minimum = cornerX[0] * anAxisX + cornerY[0] * anAxisY;
+		double maximum = minimum;
+		for (int i = 1; i < 4; ++i)
+		{
+			double projection = cornerX[i] * anAxisX + cornerY[i] * anAxisY;
+			minimum = std::min( minimum, projection);
+			maximum = std::max( maximum, projection);
+		}
+		// The projection of the swept box runs from the box at one end to the box at the other
+		double shift = aTranslation.x * anAxisX + aTranslation.y * anAxisY;
+		minimum += std::min( 0.0, shift);
+		maximum += std::max( 0.0, shift);
+		return maximum < aMinimum || minimum > aMaximum;
+	}
+} // namespace Model
@@ -0,0 +1,142 @@
+#ifndef POSE_HPP_
+#define POSE_HPP_
+
+#include "Config.hpp"
+
+#include "BoundedVector.hpp"
+#include "Point.hpp"
+#include "Size.hpp"
+
+namespace Model
+{
+	/**
+	 * The Pose is the rectangle a robot, goal or way point covers: a box of a size around a position,
+	 * turned towards a front. The corners are computed once, when the Pose is made, so a robot makes a
+	 * new Pose when it moves or turns and the collision tests only read it.
+	 *
+	 * The tests are separating axis tests: two convex shapes do not overlap if and only if there is an
+	 * axis, one of the edge normals of the shapes, on which their projections do not overlap. Shapes
+	 * that touch overlap.
+	 */
+	class Pose
+	{
+		public:
+			/**
+			 * An empty box at (0,0)
+			 */
+			Pose();
+			/**
+			 * A box that is not turned, as a Goal or a WayPoint
+			 */
+			Pose(	const Point& aPosition,
+					const Size& aSize);
+			/**
+			 * A box that is turned towards aFront, as a Robot. A front of (0,0) does not turn the box.
+			 */
+			Pose(	const Point& aPosition,
+					const Size& aSize,
+					const BoundedVector& aFront);
+			/**
+			 *
+			 */
+			Point getFrontLeft() const
+			{
+				return getCorner( FrontLeft);
+			}
+			/**
+			 *
+			 */
+			Point getFrontRight() const
+			{
+				return getCorner( FrontRight);
+			}
+			/**
+			 *
+			 */
+			Point getBackLeft() const
+			{
+				return getCorner( BackLeft);
+			}
+			/**
+			 *
+			 */
+			Point getBackRight() const
+			{
+				return getCorner( BackRight);
+			}
+			/**
+			 * Gives the smallest rectangle along the x and y axes that holds the box
+			 */
+			void getBounds(	double& aLeft,
+							double& aTop,
+							double& aRight,
+							double& aBottom) const;
+			/**
+			 *
+			 * @return true if the boxes overlap
+			 */
+			bool intersects( const Pose& aPose) const;
+			/**
+			 *
+			 * @return true if the line from aPoint1 to aPoint2 crosses or lies in the box
+			 */
+			bool intersects(	const Point& aPoint1,
+								const Point& aPoint2) const;
+			/**
+			 * The box is swept: it covers every position from its own to its own moved by aTranslation,
+			 * the convex hull of the box at both ends. A robot that drives in a straight line from
+			 * anOldPosition to its position tests with anOldPosition - position so that a step of any length
+			 * can not pass through a wall. The box keeps its angle, the turn at the start of the step is
+			 * not swept.
+			 *
+			 * @return true if the line from aPoint1 to aPoint2 crosses or lies in the swept box
+			 */
+			bool intersects(	const Point& aPoint1,
+								const Point& aPoint2,
+								const Point& aTranslation) const;
+
+		private:
+			enum Corner
+			{
+				FrontRight,
+				FrontLeft,
+				BackLeft,
+				BackRight
+			};
+			/**
+			 *
+			 */
+			Point getCorner( Corner aCorner) const
+			{
+				return Point( static_cast< int >( cornerX[aCorner]), static_cast< int >( cornerY[aCorner]));
+			}
+			/**
+			 * Sets the corners of the box around aPosition with the sides along (aCos,aSin) and
+			 * (-aSin,aCos)
+			 */
+			void setCorners(	const Point& aPosition,
+								const Size& aSize,
+								double aCos,
+								double aSin);
+			/**
+			 *
+			 * @return true if the projections of the corners of this box, swept by aTranslation, on the axis
+			 * 			(anAxisX,anAxisY) do not overlap the interval from aMinimum to aMaximum
+			 */
+			bool separates(	double anAxisX,
+							double anAxisY,
+							double aMinimum,
+							double aMaximum,
+							const Point& aTranslation = Point( 0, 0)) const;
+
+			double cornerX[4];
+			double cornerY[4];
+			/**
+			 * The direction of the front and back sides, the other sides are perpendicular
+			 */
+			double axisX;
+			double axisY;
+	};
+	//	class Pose
+} // namespace Model
+#endif // POSE_HPP_
@@ -0,0 +1,97 @@
+#include "ReservationTable.hpp"
+#include <algorithm>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	/* static */const unsigned long ReservationTable::NoTime;
+	/**
+	 *
+	 */
+	ReservationTable::ReservationTable(	int aWidth,
+										int aHeight,
+										int aDepth) :
+											width( aWidth),
+											height( aHeight),
+											depth( static_cast< std::size_t >( aDepth)),
+											cellsPerLayer( static_cast< std::size_t >( aWidth) * aHeight),
+											layerTimes( depth, NoTime),
+											counts( depth * cellsPerLayer, 0),
+											parked( cellsPerLayer, 0)
+	{
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::reserve(	const Footprint& aFootprint,
+									int anX,
+									int anY,
+									unsigned long aTime)
+	{
+		std::size_t layer = aTime % depth;
+		if (layerTimes[layer] != aTime)
+		{
+			if (layerTimes[layer] != NoTime && layerTimes[layer] > aTime)
+			{
+				return;
+			}
+			std::fill( counts.begin() + static_cast< std::ptrdiff_t >( layer * cellsPerLayer), counts.begin() + static_cast< std::ptrdiff_t >( (layer + 1) * cellsPerLayer), 0);
+			layerTimes[layer] = aTime;
+		}
+		add( aFootprint, anX, anY, &counts[layer * cellsPerLayer], 1);
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::release(	const Footprint& aFootprint,
+									int anX,
+									int anY,
+									unsigned long aTime)
+	{
+		std::size_t layer = aTime % depth;
+		if (layerTimes[layer] == aTime)
+		{
+			add( aFootprint, anX, anY, &counts[layer * cellsPerLayer], -1);
+		}
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::park(	const Footprint& aFootprint,
+									int anX,
+									int anY)
+	{
+		add( aFootprint, anX, anY, &parked[0], 1);
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::unpark(	const Footprint& aFootprint,
+									int anX,
+									int anY)
+	{
+		add( aFootprint, anX, anY, &parked[0], -1);
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::add(	const Footprint& aFootprint,
+								int anX,
+								int anY,
+								std::uint16_t* aCounts,
+								int aDelta)
+	{
+		for (const Point& offset : aFootprint)
+		{
+			int x = anX + offset.x;
+			int y = anY + offset.y;
+			if (x >= 0 && y >= 0 && x < width && y < height)
+			{
+				std::uint16_t& count = aCounts[static_cast< std::size_t >( y) * width + x];
+				count = static_cast< std::uint16_t >( count + aDelta);
+			}
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,120 @@
+#ifndef RESERVATIONTABLE_HPP_
+#define RESERVATIONTABLE_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "Point.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The ReservationTable holds the cells of a grid that robots will occupy at future time steps, for
+	 * the CooperativePlanner. A robot reserves its footprint, the offsets of the cells around its own
+	 * cell, for every step of its route; another robot may only take a cell that no footprint covers at
+	 * that step. Footprints may overlap, so every cell holds the number of reservations.
+	 *
+	 * Only the next few steps are reserved: the table is a ring of aDepth layers, the layer of a step
+	 * is the step modulo aDepth. A layer carries the step it holds and is cleared when it is reserved
+	 * for a later step, so old reservations expire without being released.
+	 *
+	 * Parked robots reserve their footprint at every step.
+	 */
+	class ReservationTable : private boost::noncopyable
+	{
+		public:
+			/**
+			 * The offsets of the cells that a robot covers from its own cell
+			 */
+			typedef std::vector< Point > Footprint;
+			/**
+			 *
+			 */
+			ReservationTable(	int aWidth,
+								int aHeight,
+								int aDepth);
+			/**
+			 *
+			 */
+			int getWidth() const
+			{
+				return width;
+			}
+			/**
+			 *
+			 */
+			int getHeight() const
+			{
+				return height;
+			}
+			/**
+			 *
+			 * @return true if no robot reserved the cell at (anX,anY), which must be in the table, at aTime
+			 */
+			bool isFree(	int anX,
+							int anY,
+							unsigned long aTime) const
+			{
+				std::size_t cell = static_cast< std::size_t >( anY) * width + anX;
+				std::size_t layer = aTime % depth;
+				return parked[cell] == 0 && (layerTimes[layer] != aTime || counts[layer * cellsPerLayer + cell] == 0);
+			}
+			/**
+			 * Reserves aFootprint around (anX,anY) at aTime. A reservation for a step that is older than
+			 * the one its layer holds is dropped, it is in the past.
+			 */
+			void reserve(	const Footprint& aFootprint,
+							int anX,
+							int anY,
+							unsigned long aTime);
+			/**
+			 * Releases a reservation made by reserve, if it has not expired
+			 */
+			void release(	const Footprint& aFootprint,
+							int anX,
+							int anY,
+							unsigned long aTime);
+			/**
+			 * Reserves aFootprint around (anX,anY) at all steps, until unpark
+			 */
+			void park(	const Footprint& aFootprint,
+						int anX,
+						int anY);
+			/**
+			 *
+			 */
+			void unpark(	const Footprint& aFootprint,
+							int anX,
+							int anY);
+
+		private:
+			/**
+			 * The step of a layer that never held one
+			 */
+			static const unsigned long NoTime = std::numeric_limits< unsigned long >::max();
+			/**
+			 * Adds aDelta to the counts of the cells of aFootprint around (anX,anY) that are in the table
+			 */
+			void add(	const Footprint& aFootprint,
+						int anX,
+						int anY,
+						std::uint16_t* aCounts,
+						int aDelta);
+
+			int width;
+			int height;
+			std::size_t depth;
+			std::size_t cellsPerLayer;
+			/**
+			 * The step of every layer, NoTime if it never held one
+			 */
+			std::vector< unsigned long > layerTimes;
+			std::vector< std::uint16_t > counts;
+			std::vector< std::uint16_t > parked;
+	}; // class ReservationTable
+} // namespace PathAlgorithm
+#endif // RESERVATIONTABLE_HPP_
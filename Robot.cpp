@@ -2,6 +2,7 @@
 #include <sstream>
 #include <ctime>
 #include <chrono>
+#include <cmath>
 #include "Thread.hpp"
 #include "MathUtils.hpp"
 #include "Logger.hpp"
@@ -14,6 +15,7 @@
 #include "Client.hpp"
 #include "Message.hpp"
 #include "MainApplication.hpp"
+#include "MultiTargetSearch.hpp"
 #include "LaserDistanceSensor.hpp"
 #include "Logger.hpp"
 
@@ -28,9 +30,15 @@ namespace Model
 								position( DefaultPosition),
 								front( 0, 0),
 								speed( 0.0),
+								planner( AStarPlanning),
+								robotCollisions( false),
+								cooperativeAgent( PathAlgorithm::CooperativePlanner::NoAgent),
+								cooperativeRouteTime( 0),
+								cancelled( false),
 								acting(false),
 								driving(false)
 	{
+		updatePose();
 		std::shared_ptr< AbstractSensor > laserSensor( new LaserDistanceSensor( this));
 		attachSensor( laserSensor);
 	}
@@ -43,9 +51,15 @@ namespace Model
 								position( DefaultPosition),
 								front( 0, 0),
 								speed( 0.0),
+								planner( AStarPlanning),
+								robotCollisions( false),
+								cooperativeAgent( PathAlgorithm::CooperativePlanner::NoAgent),
+								cooperativeRouteTime( 0),
+								cancelled( false),
 								acting(false),
 								driving(false)
 	{
+		updatePose();
 		std::shared_ptr< AbstractSensor > laserSensor( new LaserDistanceSensor( this));
 		attachSensor( laserSensor);
 	}
@@ -59,9 +73,15 @@ namespace Model
 								position( aPosition),
 								front( 0, 0),
 								speed( 0.0),
+								planner( AStarPlanning),
+								robotCollisions( false),
+								cooperativeAgent( PathAlgorithm::CooperativePlanner::NoAgent),
+								cooperativeRouteTime( 0),
+								cancelled( false),
 								acting(false),
 								driving(false)
 	{
+		updatePose();
 		std::shared_ptr< AbstractSensor > laserSensor( new LaserDistanceSensor( this));
 		attachSensor( laserSensor);
 	}
@@ -78,6 +98,10 @@ namespace Model
 		{
 			stopActing();
 		}
+		if (cooperativeAgent != PathAlgorithm::CooperativePlanner::NoAgent)
+		{
+			PathAlgorithm::CooperativePlanner::getCooperativePlanner().removeAgent( cooperativeAgent);
+		}
 	}
 	/**
 	 *
@@ -106,6 +130,7 @@ namespace Model
 							bool aNotifyObservers /*= true*/)
 	{
 		size = aSize;
+		updatePose();
 		if (aNotifyObservers == true)
 		{
 			notifyObservers();
@@ -118,6 +143,7 @@ namespace Model
 								bool aNotifyObservers /*= true*/)
 	{
 		position = aPosition;
+		updatePose();
 		if (aNotifyObservers == true)
 		{
 			notifyObservers();
@@ -137,6 +163,7 @@ namespace Model
 							bool aNotifyObservers /*= true*/)
 	{
 		front = aVector;
+		updatePose();
 		if (aNotifyObservers == true)
 		{
 			notifyObservers();
@@ -171,7 +198,23 @@ namespace Model
 		if(goal != nullptr)
 		{
 			acting = true;
-			std::thread newRobotThread( [this]{	startDriving(goal);});
+			cancelled = false;
+			std::thread newRobotThread( [this]
+			{
+				// -nearest_goal drives to the goal with the shortest route instead of the one named "Goal"
+				if (Application::MainApplication::isArgGiven( "-nearest_goal"))
+				{
+					GoalPtr nearestGoal = findNearestGoal();
+					if (nearestGoal)
+					{
+						goal = nearestGoal;
+					}
+				}
+				if (!cancelled)
+				{
+					startDriving(goal);
+				}
+			});
 			robotThread.swap( newRobotThread);
 		}
 		else
@@ -186,6 +229,12 @@ namespace Model
 	{
 		acting = false;
 		driving = false;
+		cancelled = true;
+		PathAlgorithm::PlanPtr currentPlan = std::atomic_load( &plan);
+		if (currentPlan)
+		{
+			currentPlan->cancel();
+		}
 		robotThread.join();
 	}
 	/**
@@ -195,7 +244,11 @@ namespace Model
 	{
 		driving = true;
 		calculateRoute(aGoal);
-		drive();
+		// Stopped while planning
+		if (driving)
+		{
+			drive();
+		}
 	}
 
 	/**
@@ -210,90 +263,77 @@ namespace Model
 	/**
 	 *
 	 */
-	Region Robot::getRegion() const
+	bool Robot::intersects( const Robot& aRobot) const
 	{
-		Point translatedPoints[] = { getFrontRight(), getFrontLeft(), getBackLeft(), getBackRight() };
-		return Region( 4, translatedPoints);
+		return pose.intersects( aRobot.pose);
 	}
 	/**
 	 *
 	 */
-	bool Robot::intersects( const Region& aRegion) const
+	Point Robot::getFrontLeft() const
 	{
-		Region region = getRegion();
-		region.Intersect( aRegion);
-		return !region.IsEmpty();
+		return pose.getFrontLeft();
 	}
 	/**
 	 *
 	 */
-	Point Robot::getFrontLeft() const
+	Point Robot::getFrontRight() const
 	{
-		// x and y are pointing to top left now
-		int x = position.x - (size.x / 2);
-		int y = position.y - (size.y / 2);
-
-		Point originalFrontLeft( x, y);
-		double angle = Utils::Shape2DUtils::getAngle( front) + 0.5 * Utils::PI;
-
-		Point frontLeft( (originalFrontLeft.x - position.x) * std::cos( angle) - (originalFrontLeft.y - position.y) * std::sin( angle) + position.x, (originalFrontLeft.y - position.y) * std::cos( angle)
-		+ (originalFrontLeft.x - position.x) * std::sin( angle) + position.y);
-
-		return frontLeft;
+		return pose.getFrontRight();
 	}
 	/**
 	 *
 	 */
-	Point Robot::getFrontRight() const
+	Point Robot::getBackLeft() const
 	{
-		// x and y are pointing to top left now
-		int x = position.x - (size.x / 2);
-		int y = position.y - (size.y / 2);
-
-		Point originalFrontRight( x + size.x, y);
-		double angle = Utils::Shape2DUtils::getAngle( front) + 0.5 * Utils::PI;
-
-		Point frontRight( (originalFrontRight.x - position.x) * std::cos( angle) - (originalFrontRight.y - position.y) * std::sin( angle) + position.x, (originalFrontRight.y - position.y)
-						  * std::cos( angle) + (originalFrontRight.x - position.x) * std::sin( angle) + position.y);
-
-		return frontRight;
+		return pose.getBackLeft();
 	}
 	/**
 	 *
 	 */
-	Point Robot::getBackLeft() const
+	Point Robot::getBackRight() const
 	{
-		// x and y are pointing to top left now
-		int x = position.x - (size.x / 2);
-		int y = position.y - (size.y / 2);
-
-		Point originalBackLeft( x, y + size.y);
-
-		double angle = Utils::Shape2DUtils::getAngle( front) + 0.5 * Utils::PI;
-
-		Point backLeft( (originalBackLeft.x - position.x) * std::cos( angle) - (originalBackLeft.y - position.y) * std::sin( angle) + position.x, (originalBackLeft.y - position.y) * std::cos( angle)
-		+ (originalBackLeft.x - position.x) * std::sin( angle) + position.y);
-
-		return backLeft;
-
+		return pose.getBackRight();
 	}
 	/**
 	 *
 	 */
-	Point Robot::getBackRight() const
+	void Robot::updatePose()
 	{
-		// x and y are pointing to top left now
-		int x = position.x - (size.x / 2);
-		int y = position.y - (size.y / 2);
-
-		Point originalBackRight( x + size.x, y + size.y);
-
-		double angle = Utils::Shape2DUtils::getAngle( front) + 0.5 * Utils::PI;
-
-		Point backRight( (originalBackRight.x - position.x) * std::cos( angle) - (originalBackRight.y - position.y) * std::sin( angle) + position.x, (originalBackRight.y - position.y) * std::cos( angle)
-		+ (originalBackRight.x - position.x) * std::sin( angle) + position.y);
-
-		return backRight;
+		pose = Pose( position, size, front);
+	}
+	/**
+	 * -planner=jps selects Jump Point Search, -planner=theta any-angle Lazy Theta*, -planner=hpa the
+	 * hierarchical planner, -planner=dstar the incremental planner, -planner=flow the flow field of the
+	 * goal and -planner=cooperative the planner that plans around the routes of the other robots.
+	 * -robot_collisions also stops the robot when it touches another robot.
+	 */
+	void Robot::readArguments()
+	{
+		std::string plannerName = Application::MainApplication::isArgGiven( "-planner") ? Application::MainApplication::getArg( "-planner").value : "";
+		if (plannerName == "jps")
+		{
+			planner = JumpPointPlanning;
+		} else if (plannerName == "theta")
+		{
+			planner = ThetaStarPlanning;
+		} else if (plannerName == "hpa")
+		{
+			planner = HierarchicalPlanning;
+		} else if (plannerName == "dstar")
+		{
+			planner = IncrementalPlanning;
+		} else if (plannerName == "flow")
+		{
+			planner = FlowFieldPlanning;
+		} else if (plannerName == "cooperative")
+		{
+			planner = CooperativePlanning;
+		} else
+		{
+			planner = AStarPlanning;
+		}
+		robotCollisions = Application::MainApplication::isArgGiven( "-robot_collisions");
 	}
 	/**
 	 *
@@ -302,11 +342,8 @@ namespace Model
 	{
 		//	std::unique_lock<std::recursive_mutex> lock(robotMutex);
 
-		static int update = 0;
-		if ((++update % 200) == 0)
-		{
-			notifyObservers();
-		}
+		// The Plan already limits its notifications to its progress interval
+		notifyObservers();
 	}
 
 	/**
@@ -346,18 +383,90 @@ namespace Model
 				sensor->setOn();
 			}
 
+			// The walls are tested over the whole line of a step, so -speed may take large steps
 			if (speed == 0.0)
 			{
-				speed = 10.0;
+				speed = Application::MainApplication::isArgGiven( "-speed") ? std::stof( Application::MainApplication::getArg( "-speed").value) : 10.0f;
 			}
 
-			unsigned pathPoint = 0;
-			while (position.x > 0 && position.x < 500 && position.y > 0 && position.y < 500 && pathPoint < path.size())
+			// The path is one vertex per cell or, after any-angle planning or smoothing, a few straight
+			// segments: the robot drives speed pixels along it per step. pathPoint is the start of the
+			// segment it is on and segmentDistance the distance it drove along that segment.
+			std::size_t pathPoint = 0;
+			double segmentDistance = 0.0;
+			while (position.x > 0 && position.x < 500 && position.y > 0 && position.y < 500 && pathPoint + 1 < path.size())
 			{
-				const PathAlgorithm::Vertex& vertex = path[pathPoint+=speed];
-				front = BoundedVector( vertex.asPoint(), position);
-				position.x = vertex.x;
-				position.y = vertex.y;
+				// The incremental planner and the flow field repair the route while driving if the walls changed
+				unsigned long wallRevision = Model::RobotWorld::getRobotWorld().getWallRevision();
+				if ((planner == IncrementalPlanning && incrementalPlanner.getWallRevision() != wallRevision) ||
+					(planner == FlowFieldPlanning && flowField && flowField->getWallRevision() != wallRevision))
+				{
+					if (planner == IncrementalPlanning)
+					{
+						incrementalPlanner.search( position, goal->getPosition(), size, path);
+					} else
+					{
+						flowField = PathAlgorithm::FlowField::getFlowField( goal->getPosition(), size, position);
+						flowField->getPath( position, path);
+					}
+					if (Application::MainApplication::isArgGiven( "-smooth_path"))
+					{
+						PathAlgorithm::AStar::smoothPath( size, path);
+					}
+					pathPoint = 0;
+					segmentDistance = 0.0;
+					if (path.size() < 2)
+					{
+						Application::Logger::log(__PRETTY_FUNCTION__ + std::string(": no route"));
+						notifyObservers();
+						break;
+					}
+				}
+
+				double distance = speed;
+				Point next = path.back();
+				if (planner == CooperativePlanning)
+				{
+					// The route has a point per step of the planner and is planned again every half window
+					PathAlgorithm::CooperativePlanner& cooperativePlanner = PathAlgorithm::CooperativePlanner::getCooperativePlanner();
+					unsigned long time = cooperativePlanner.getTime();
+					std::size_t step = std::min( static_cast< std::size_t >( time - cooperativeRouteTime), path.size() - 1);
+					if (step >= static_cast< std::size_t >( cooperativePlanner.getWindow() / 2) || step + 1 == path.size())
+					{
+						Point current = path[step];
+						cooperativeRouteTime = time;
+						if (!cooperativePlanner.plan( cooperativeAgent, current, goal->getPosition(), time, path))
+						{
+							Application::Logger::log(__PRETTY_FUNCTION__ + std::string(": no route"));
+							notifyObservers();
+							break;
+						}
+						step = 0;
+					}
+					next = path[step];
+				}
+				while (planner != CooperativePlanning && pathPoint + 1 < path.size())
+				{
+					Point from = path[pathPoint];
+					Point to = path[pathPoint + 1];
+					double length = std::hypot( to.x - from.x, to.y - from.y);
+					if (segmentDistance + distance < length)
+					{
+						segmentDistance += distance;
+						next = Point( static_cast< int >( std::lround( from.x + (to.x - from.x) * segmentDistance / length)),
+									  static_cast< int >( std::lround( from.y + (to.y - from.y) * segmentDistance / length)));
+						break;
+					}
+					distance -= length - segmentDistance;
+					segmentDistance = 0.0;
+					++pathPoint;
+				}
+				Point oldPosition = position;
+				front = BoundedVector( next, position);
+				position.x = next.x;
+				position.y = next.y;
+				updatePose();
+				RobotWorld::getRobotWorld().robotMoved( *this);
 
 				if (arrived(goal))
 				{
@@ -367,12 +476,23 @@ namespace Model
 				}
 				else
 				{
-					if(collision())
+					if(collision( oldPosition))
 					{
 						Application::Logger::log(__PRETTY_FUNCTION__ + std::string(": collision"));
 						notifyObservers();
 						break;
 					}
+					if (robotCollisions)
+					{
+						std::vector< RobotPtr > robots;
+						RobotWorld::getRobotWorld().getCollidingRobots( *this, robots);
+						if (!robots.empty())
+						{
+							Application::Logger::log(__PRETTY_FUNCTION__ + std::string(": collision with ") + robots.front()->getName());
+							notifyObservers();
+							break;
+						}
+					}
 				}
 
 				notifyObservers();
@@ -407,10 +527,16 @@ namespace Model
 				// this should be the last thing in the loop
 				if(driving == false)
 				{
-					return;
+					break;
 				}
 			} // while
 
+			// The other robots plan around a cooperative robot that stopped
+			if (cooperativeAgent != PathAlgorithm::CooperativePlanner::NoAgent)
+			{
+				PathAlgorithm::CooperativePlanner::getCooperativePlanner().park( cooperativeAgent, position);
+			}
+
 			//TODO Loop met sensor->setOff() in comments
 			for (std::shared_ptr< AbstractSensor > sensor : sensors)
 			{
@@ -437,26 +563,147 @@ namespace Model
 		return ss.str();
 	}
 
+	/**
+	 *
+	 */
+	GoalPtr Robot::findNearestGoal()
+	{
+		const std::vector< GoalPtr >& goals = RobotWorld::getRobotWorld().getGoals();
+		std::vector< Point > targets;
+		for (GoalPtr aGoal : goals)
+		{
+			targets.push_back( aGoal->getPosition());
+		}
+
+		// One search for all goals instead of one per goal
+		PathAlgorithm::MultiTargetSearch search;
+		search.setCancellationFlag( &cancelled);
+		search.searchFrom( position, targets, size);
+		std::size_t nearest = search.getNearest();
+		return nearest == PathAlgorithm::MultiTargetSearch::NoPoint ? GoalPtr() : goals[nearest];
+	}
 	/**
 	 *
 	 */
 	void Robot::calculateRoute(GoalPtr aGoal)
 	{
-		path.clear();
 		if (aGoal != nullptr)
 		{
 			// Turn off logging if not debugging AStar
 			Application::Logger::setDisable();
 
 			front = BoundedVector( aGoal->getPosition(), position);
-			handleNotificationsFor( astar);
-			path = astar.search( position, aGoal->getPosition(), size);
-			stopHandlingNotificationsFor( astar);
+			updatePose();
+
+			readArguments();
+			bool plannedOnService = false;
+			if (cancelled)
+			{
+				// Stopped before planning, the planners on this thread can not be cancelled once started
+				path.clear();
+			} else if (planner == CooperativePlanning)
+			{
+				PathAlgorithm::CooperativePlanner& cooperativePlanner = PathAlgorithm::CooperativePlanner::getCooperativePlanner();
+				if (cooperativeAgent == PathAlgorithm::CooperativePlanner::NoAgent)
+				{
+					cooperativeAgent = cooperativePlanner.addAgent( position, size);
+				}
+				cooperativeRouteTime = cooperativePlanner.getTime();
+				if (!cooperativePlanner.plan( cooperativeAgent, position, aGoal->getPosition(), cooperativeRouteTime, path))
+				{
+					path.clear();
+					cooperativePlanner.park( cooperativeAgent, position);
+				}
+			} else if (planner == HierarchicalPlanning)
+			{
+				hierarchicalPlanner.search( position, aGoal->getPosition(), size, path);
+			} else if (planner == IncrementalPlanning)
+			{
+				incrementalPlanner.search( position, aGoal->getPosition(), size, path);
+			} else if (planner == FlowFieldPlanning)
+			{
+				// All robots of the same size that drive to the same goal follow one field
+				flowField = PathAlgorithm::FlowField::getFlowField( aGoal->getPosition(), size, position);
+				flowField->getPath( position, path);
+			} else
+			{
+				// The search runs on the PlanningService, stopActing cancels it
+				PathAlgorithm::PlanRequest request( position, aGoal->getPosition(), size);
+				if (planner == JumpPointPlanning)
+				{
+					request.strategy = PathAlgorithm::AStar::JumpPointSearch;
+				} else if (planner == ThetaStarPlanning)
+				{
+					request.strategy = PathAlgorithm::AStar::LazyThetaStar;
+				}
+				// -plan_budget=<ms> limits the duration of the search
+				if (Application::MainApplication::isArgGiven( "-plan_budget"))
+				{
+					request.timeBudget = std::chrono::milliseconds( std::stol( Application::MainApplication::getArg( "-plan_budget").value));
+				}
+				// -plan_weight=<w> with w > 1 plans anytime: the best route found within the budget,
+				// at most w times longer than the shortest one
+				if (Application::MainApplication::isArgGiven( "-plan_weight"))
+				{
+					request.weight = std::stod( Application::MainApplication::getArg( "-plan_weight").value);
+				}
+				// -landmarks guides the search with the distances to landmarks, once they are built
+				request.landmarks = Application::MainApplication::isArgGiven( "-landmarks");
+				// A view that observes the robot shows the progress of the search every 1000 expanded
+				// vertices, about 40 times for the default world. -search_progress=<ms> publishes it every
+				// <ms> instead, also without a view, and -search_progress=0 turns it off.
+				if (Application::MainApplication::isArgGiven( "-search_progress"))
+				{
+					request.progressInterval = std::chrono::milliseconds( std::stol( Application::MainApplication::getArg( "-search_progress").value));
+				} else if (hasObservers())
+				{
+					request.progressExpansions = 1000;
+				}
+
+				PathAlgorithm::PlanPtr newPlan = std::make_shared< PathAlgorithm::Plan >( request, nullptr);
+				handleNotificationsFor( *newPlan);
+				std::atomic_store( &plan, newPlan);
+				// stopActing may have loaded the previous plan just before the store
+				if (cancelled)
+				{
+					newPlan->cancel();
+				}
+				PathAlgorithm::PlanningService::getPlanningService().submit( newPlan);
+				plannedOnService = true;
+
+				try
+				{
+					PathAlgorithm::PlanResult result = newPlan->getResult().get();
+					path.swap( result.path);
+				}
+				catch (std::exception& e)
+				{
+					path.clear();
+					std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+				}
+				stopHandlingNotificationsFor( *newPlan);
+			}
+			// -smooth_path reduces the route to the straight segments between the corners around the walls,
+			// a cooperative route is timed per point and is not smoothed
+			if (planner != CooperativePlanning && Application::MainApplication::isArgGiven( "-smooth_path"))
+			{
+				PathAlgorithm::AStar::smoothPath( size, path);
+			}
 
 			Application::Logger::setDisable( false);
+
+			// The cache is shared by all robots, the counts show its effect in a fleet run
+			if (plannedOnService)
+			{
+				const PathAlgorithm::PathCache& pathCache = PathAlgorithm::PlanningService::getPlanningService().getPathCache();
+				std::ostringstream os;
+				os << "Path cache: " << pathCache.getHits() << " hits, " << pathCache.getMisses() << " misses";
+				Application::Logger::log( os.str());
+			}
 		}
 		else
 		{
+			path.clear();
 			throw(std::logic_error("No goal found"));
 		}
 	}
@@ -468,7 +715,7 @@ namespace Model
 	{
 		if(aGoal != nullptr)
 		{
-			if(intersects( aGoal->getRegion()))
+			if(pose.intersects( aGoal->getPose()))
 			{
 				return true;
 			}
@@ -486,19 +733,20 @@ namespace Model
 	/**
 	 * TODO Een robot raakt nooit een muur?
 	 */
-	bool Robot::collision()
+	bool Robot::collision( const Point& anOldPosition)
 	{
-		Point frontLeft = getFrontLeft();
-		Point frontRight = getFrontRight();
-		Point backLeft = getBackLeft();
-		Point backRight = getBackRight();
+		// Only the walls that come within the half diagonal of the robot of the line it drove can touch it
+		int radius = static_cast< int >( std::ceil( std::sqrt( (size.x / 2.0) * (size.x / 2.0) + (size.y / 2.0) * (size.y / 2.0)))) + 1;
+
+		// The GUI may move the end points of the walls meanwhile
+		std::lock_guard< std::recursive_mutex > lock( RobotWorld::getRobotWorld().getWallsMutex());
+		std::vector< WallPtr > walls;
+		RobotWorld::getRobotWorld().getWallsNear( anOldPosition, position, radius, walls);
 
-		const std::vector< WallPtr >& walls = RobotWorld::getRobotWorld().getWalls();
+		Point translation( anOldPosition.x - position.x, anOldPosition.y - position.y);
 		for (WallPtr wall : walls)
 		{
-			if (Utils::Shape2DUtils::intersect( frontLeft, frontRight, wall->getPoint1(), wall->getPoint2()) ||
-							Utils::Shape2DUtils::intersect( frontLeft, backLeft, wall->getPoint1(), wall->getPoint2())	||
-							Utils::Shape2DUtils::intersect( frontRight, backRight, wall->getPoint1(), wall->getPoint2()))
+			if (pose.intersects( wall->getPoint1(), wall->getPoint2(), translation))
 			{
 				return true;
 			}
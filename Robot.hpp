@@ -3,6 +3,7 @@
 
 #include "Config.hpp"
 
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -10,14 +11,18 @@
 #include <thread>
 
 #include "AbstractAgent.hpp"
-#include "AStar.hpp"
 #include "BoundedVector.hpp"
+#include "CooperativePlanner.hpp"
+#include "DStarLite.hpp"
+#include "FlowField.hpp"
+#include "HierarchicalPlanner.hpp"
 #include "Message.hpp"
 #include "MessageHandler.hpp"
 #include "Observer.hpp"
+#include "PlanningService.hpp"
 #include "Point.hpp"
+#include "Pose.hpp"
 #include "Size.hpp"
-#include "Region.hpp"
 
 namespace Messaging
 {
@@ -117,7 +122,10 @@ namespace Model
 			 */
 			virtual void startActing();
 			/**
-			 *
+			 * Cancels the planning and stops driving, and waits for the robot thread. A search on the
+			 * PlanningService or for the nearest goal stops at once; -planner=hpa, dstar, flow and
+			 * cooperative search on the robot thread and can not be cancelled, the robot only skips them
+			 * if it was stopped before they started.
 			 */
 			virtual void stopActing();
 			/**
@@ -147,12 +155,17 @@ namespace Model
 
 			/**
 			 *
+			 * @return The box the robot covers at its position, turned towards its front
 			 */
-			Region getRegion() const;
+			Pose getPose() const
+			{
+				return pose;
+			}
 			/**
 			 *
+			 * @return true if the robot overlaps aRobot
 			 */
-			bool intersects( const Region& aRegion) const;
+			bool intersects( const Robot& aRobot) const;
 			/**
 			 *
 			 */
@@ -183,9 +196,10 @@ namespace Model
 			/**
 			 *
 			 */
-			PathAlgorithm::OpenSet getOpenSet() const
+			PathAlgorithm::OpenSetSnapshot getOpenSet() const
 			{
-				return astar.getOpenSet();
+				PathAlgorithm::PlanPtr currentPlan = std::atomic_load( &plan);
+				return currentPlan ? currentPlan->getOpenSet() : PathAlgorithm::OpenSetSnapshot();
 			}
 			/**
 			 *
@@ -219,14 +233,21 @@ namespace Model
 			 *
 			 */
 			void calculateRoute(GoalPtr aGoal);
+			/**
+			 *
+			 * @return The goal with the shortest route from the current position, nullptr if none can be reached
+			 */
+			GoalPtr findNearestGoal();
 			/**
 			 *
 			 */
 			bool arrived(GoalPtr aGoal);
 			/**
 			 *
+			 * @return true if the robot touched a wall while it drove in a straight line from anOldPosition
+			 * 			to its position
 			 */
-			bool collision();
+			bool collision( const Point& anOldPosition);
 
 		private:
 			std::string name;
@@ -236,9 +257,63 @@ namespace Model
 
 			BoundedVector front;
 			float speed;
+			/**
+			 * The box of the robot for the current position, size and front
+			 */
+			Pose pose;
+			/**
+			 * Recomputes the pose, after every change of the position, size or front
+			 */
+			void updatePose();
+			/**
+			 * The planner that -planner selects
+			 */
+			enum Planner
+			{
+				/**
+				 * A* on the PlanningService, without -planner or with an unknown planner
+				 */
+				AStarPlanning,
+				JumpPointPlanning,
+				ThetaStarPlanning,
+				HierarchicalPlanning,
+				IncrementalPlanning,
+				FlowFieldPlanning,
+				CooperativePlanning
+			};
+			/**
+			 * Reads -planner and -robot_collisions into planner and robotCollisions, once per route
+			 * instead of on every step of drive
+			 */
+			void readArguments();
 
 			GoalPtr goal;
-			PathAlgorithm::AStar astar;
+			Planner planner;
+			/**
+			 * true if the robot also stops when it touches another robot
+			 */
+			bool robotCollisions;
+			PathAlgorithm::HierarchicalPlanner hierarchicalPlanner;
+			PathAlgorithm::DStarLite incrementalPlanner;
+			/**
+			 * The field of the goal if the robot drives with -planner=flow
+			 */
+			PathAlgorithm::FlowFieldPtr flowField;
+			/**
+			 * The agent of the robot in the shared CooperativePlanner if it drives with
+			 * -planner=cooperative, and the step of the planner at which its route starts
+			 */
+			std::size_t cooperativeAgent;
+			unsigned long cooperativeRouteTime;
+			/**
+			 * The last Plan submitted to the PlanningService, only accessed with std::atomic_load and std::atomic_store
+			 */
+			PathAlgorithm::PlanPtr plan;
+			/**
+			 * Set by stopActing before it cancels the plan. The robot thread tests it after it published
+			 * a new plan, so a plan made while stopActing runs is cancelled as well.
+			 */
+			std::atomic< bool > cancelled;
 			PathAlgorithm::Path path;
 
 			bool acting;
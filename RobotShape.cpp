@@ -91,11 +91,11 @@ namespace View
 			getRobot()->setSize( size, false);
 		}
 
-		PathAlgorithm::OpenSet openSet = getRobot()->getOpenSet();
-		if (openSet.size() != 0)
+		PathAlgorithm::OpenSetSnapshot openSet = getRobot()->getOpenSet();
+		if (openSet && openSet->size() != 0)
 		{
 			dc.SetPen( wxPen( WXSTRING( "PALE GREEN"), borderWidth, wxSOLID));
-			for (const PathAlgorithm::Vertex& vertex : openSet)
+			for (const PathAlgorithm::Vertex& vertex : *openSet)
 			{
 				dc.DrawPoint( vertex.asPoint());
 			}
@@ -104,10 +104,12 @@ namespace View
 		PathAlgorithm::Path path = getRobot()->getPath();
 		if (path.size() != 0)
 		{
+			// The path may consist of a few straight segments only
 			dc.SetPen( wxPen( WXSTRING( "BLACK"), borderWidth, wxSOLID));
-			for (const PathAlgorithm::Vertex& vertex : path)
+			dc.DrawPoint( path.front());
+			for (std::size_t i = 1; i < path.size(); ++i)
 			{
-				dc.DrawPoint( vertex.asPoint());
+				dc.DrawLine( path[i - 1], path[i]);
 			}
 		}
 
@@ -29,6 +29,16 @@ namespace Model
 	{
 		RobotPtr robot( new Robot( aName, aPosition));
 		robots.push_back( robot);
+		{
+			std::lock_guard< std::mutex > lock( robotBroadphaseMutex);
+			std::size_t handle = robotBroadphase.add( robot->getPose());
+			robotHandles[robot.get()] = handle;
+			if (handle >= robotsByHandle.size())
+			{
+				robotsByHandle.resize( handle + 1);
+			}
+			robotsByHandle[handle] = robot;
+		}
 		if (aNotifyObservers == true)
 		{
 			notifyObservers();
@@ -73,7 +83,12 @@ namespace Model
 								bool aNotifyObservers /*= true*/)
 	{
 		WallPtr wall( new Wall( aPoint1, aPoint2));
-		walls.push_back( wall);
+		{
+			std::lock_guard< std::recursive_mutex > lock( wallsMutex);
+			walls.push_back( wall);
+			wallIndex.insert( wall);
+		}
+		addWallChange( aPoint1, aPoint2);
 		if (aNotifyObservers == true)
 		{
 			notifyObservers();
@@ -92,6 +107,7 @@ namespace Model
 							   });
 		if (i != robots.end())
 		{
+			removeFromBroadphase( **i);
 			robots.erase( i);
 			if (aNotifyObservers == true)
 			{
@@ -152,7 +168,12 @@ namespace Model
 							   });
 		if (i != walls.end())
 		{
-			walls.erase( i);
+			{
+				std::lock_guard< std::recursive_mutex > lock( wallsMutex);
+				wallIndex.remove( **i, (*i)->getPoint1(), (*i)->getPoint2());
+				addWallChange( (*i)->getPoint1(), (*i)->getPoint2());
+				walls.erase( i);
+			}
 
 			if (aNotifyObservers == true)
 			{
@@ -287,6 +308,165 @@ namespace Model
 	{
 		return walls;
 	}
+	/**
+	 *
+	 */
+	void RobotWorld::getWallLines( std::vector< std::pair< Point, Point > >& aLines) const
+	{
+		std::lock_guard< std::recursive_mutex > lock( wallsMutex);
+		aLines.reserve( aLines.size() + walls.size());
+		for (WallPtr wall : walls)
+		{
+			aLines.push_back( std::make_pair( wall->getPoint1(), wall->getPoint2()));
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::getWallsNear(	const Point& aPoint,
+									int aRadius,
+									std::vector< WallPtr >& aWalls) const
+	{
+		std::lock_guard< std::recursive_mutex > lock( wallsMutex);
+		wallIndex.getWallsNear( aPoint, aRadius, aWalls);
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::getWallsNear(	const Point& aPoint1,
+									const Point& aPoint2,
+									int aRadius,
+									std::vector< WallPtr >& aWalls) const
+	{
+		std::lock_guard< std::recursive_mutex > lock( wallsMutex);
+		wallIndex.getWallsNear( aPoint1, aPoint2, aRadius, aWalls);
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::getWallsAlong(	const Point& aPoint1,
+									const Point& aPoint2,
+									std::vector< WallPtr >& aWalls) const
+	{
+		std::lock_guard< std::recursive_mutex > lock( wallsMutex);
+		wallIndex.getWallsAlong( aPoint1, aPoint2, aWalls);
+	}
+	/**
+	 *
+	 */
+	unsigned long RobotWorld::getWallRevision() const
+	{
+		return wallRevision;
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::wallChanged( 	const Wall& aWall,
+									const Point& anOldPoint1,
+									const Point& anOldPoint2)
+	{
+		{
+			std::lock_guard< std::recursive_mutex > lock( wallsMutex);
+			wallIndex.move( aWall, anOldPoint1, anOldPoint2);
+		}
+		addWallChange( anOldPoint1, anOldPoint2);
+		addWallChange( aWall.getPoint1(), aWall.getPoint2());
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::robotMoved( const Robot& aRobot)
+	{
+		std::lock_guard< std::mutex > lock( robotBroadphaseMutex);
+		std::unordered_map< const Robot*, std::size_t >::const_iterator handle = robotHandles.find( &aRobot);
+		if (handle != robotHandles.end())
+		{
+			robotBroadphase.update( handle->second, aRobot.getPose());
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::getCollidingRobots(	const Robot& aRobot,
+											std::vector< RobotPtr >& aRobots) const
+	{
+		std::lock_guard< std::mutex > lock( robotBroadphaseMutex);
+		std::unordered_map< const Robot*, std::size_t >::const_iterator handle = robotHandles.find( &aRobot);
+		if (handle != robotHandles.end())
+		{
+			std::vector< std::size_t > handles;
+			robotBroadphase.findOverlaps( handle->second, handles);
+			for (std::size_t other : handles)
+			{
+				aRobots.push_back( robotsByHandle[other]);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::getCollidingRobots( std::vector< std::pair< RobotPtr, RobotPtr > >& aPairs) const
+	{
+		std::lock_guard< std::mutex > lock( robotBroadphaseMutex);
+		std::vector< std::pair< std::size_t, std::size_t > > pairs;
+		robotBroadphase.findPairs( pairs);
+		for (const std::pair< std::size_t, std::size_t >& pair : pairs)
+		{
+			aPairs.push_back( std::make_pair( robotsByHandle[pair.first], robotsByHandle[pair.second]));
+		}
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::removeFromBroadphase( const Robot& aRobot)
+	{
+		std::lock_guard< std::mutex > lock( robotBroadphaseMutex);
+		std::unordered_map< const Robot*, std::size_t >::const_iterator handle = robotHandles.find( &aRobot);
+		if (handle != robotHandles.end())
+		{
+			robotBroadphase.remove( handle->second);
+			robotsByHandle[handle->second] = nullptr;
+			robotHandles.erase( handle);
+		}
+	}
+	/**
+	 *
+	 */
+	bool RobotWorld::getWallChangesSince( 	unsigned long aRevision,
+											std::vector< WallChange >& aChanges) const
+	{
+		std::lock_guard< std::mutex > lock( wallChangesMutex);
+		if (aRevision < wallChangesBase)
+		{
+			return false;
+		}
+		for (const WallChange& wallChange : wallChanges)
+		{
+			if (wallChange.revision > aRevision)
+			{
+				aChanges.push_back( wallChange);
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	void RobotWorld::addWallChange( const Point& aPoint1,
+									const Point& aPoint2)
+	{
+		// Enough for a few drags of a wall end point between two plans
+		static const std::size_t maximumWallChanges = 1024;
+
+		std::lock_guard< std::mutex > lock( wallChangesMutex);
+		WallChange wallChange = { ++wallRevision, aPoint1, aPoint2 };
+		wallChanges.push_back( wallChange);
+		if (wallChanges.size() > maximumWallChanges)
+		{
+			wallChangesBase = wallChanges.front().revision;
+			wallChanges.pop_front();
+		}
+	}
 	/**
 	 *
 	 */
@@ -313,10 +493,24 @@ namespace Model
 	 */
 	void RobotWorld::unpopulate( bool aNotifyObservers /*= true*/)
 	{
+		{
+			std::lock_guard< std::mutex > lock( robotBroadphaseMutex);
+			robotBroadphase.clear();
+			robotHandles.clear();
+			robotsByHandle.clear();
+		}
 		robots.clear();
 		wayPoints.clear();
 		goals.clear();
-		walls.clear();
+		{
+			std::lock_guard< std::recursive_mutex > lock( wallsMutex);
+			for (WallPtr wall : walls)
+			{
+				addWallChange( wall->getPoint1(), wall->getPoint2());
+			}
+			walls.clear();
+			wallIndex.clear();
+		}
 
 		if (aNotifyObservers)
 		{
@@ -333,11 +527,16 @@ namespace Model
 		{
 			robots.erase(	std::remove_if(	robots.begin(),
 											robots.end(),
-											[&aKeepObjects](RobotPtr aRobot)
+											[this,&aKeepObjects](RobotPtr aRobot)
 											{
-											 return std::find(	aKeepObjects.begin(),
-																aKeepObjects.end(),
-																aRobot->getObjectId()) == aKeepObjects.end();
+											 if (std::find(	aKeepObjects.begin(),
+															aKeepObjects.end(),
+															aRobot->getObjectId()) == aKeepObjects.end())
+											 {
+												 removeFromBroadphase( *aRobot);
+												 return true;
+											 }
+											 return false;
 											}),
 							robots.end());
 		}
@@ -367,13 +566,20 @@ namespace Model
 		}
 		if(walls.size()>0)
 		{
+			std::lock_guard< std::recursive_mutex > lock( wallsMutex);
 			walls.erase(	std::remove_if(	walls.begin(),
 											walls.end(),
-											[&aKeepObjects](WallPtr aWall)
+											[this,&aKeepObjects](WallPtr aWall)
 											{
-											 return std::find(	aKeepObjects.begin(),
-																aKeepObjects.end(),
-																aWall->getObjectId()) == aKeepObjects.end();
+											 if (std::find(	aKeepObjects.begin(),
+															aKeepObjects.end(),
+															aWall->getObjectId()) == aKeepObjects.end())
+											 {
+												 wallIndex.remove( *aWall, aWall->getPoint1(), aWall->getPoint2());
+												 addWallChange( aWall->getPoint1(), aWall->getPoint2());
+												 return true;
+											 }
+											 return false;
 											}),
 							walls.end());
 		}
@@ -421,7 +627,7 @@ namespace Model
 	/**
 	 *
 	 */
-	RobotWorld::RobotWorld() : localPort("12345"), remotePort("12346"), communicating(false), pointer(this)
+	RobotWorld::RobotWorld() : wallRevision( 0), wallChangesBase( 0), localPort("12345"), remotePort("12346"), communicating(false), pointer(this)
 	{
 	}
 	/**
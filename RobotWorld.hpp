@@ -2,11 +2,18 @@
 #define ROBOTWORLD_HPP_
 
 #include "Config.hpp"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
+#include "Broadphase.hpp"
 #include "ModelObject.hpp"
 #include "Point.hpp"
 #include "Message.hpp"
 #include "MessageHandler.hpp"
+#include "WallIndex.hpp"
 
 namespace Model
 {
@@ -25,6 +32,17 @@ namespace Model
 	class RobotWorld;
 	typedef std::shared_ptr<RobotWorld> RobotWorldPtr;
 
+	/**
+	 * The line of a wall that was added, deleted or moved. A moved wall results in two changes:
+	 * one for the old and one for the new position.
+	 */
+	struct WallChange
+	{
+			unsigned long revision;
+			Point point1;
+			Point point2;
+	};
+
 	/**
 	 *
 	 */
@@ -124,6 +142,75 @@ namespace Model
 			 *
 			 */
 			const std::vector< WallPtr >& getWalls() const;
+			/**
+			 * Copies the end points of all walls under the lock of the walls, for the threads that read
+			 * the walls while the GUI edits them
+			 */
+			void getWallLines( std::vector< std::pair< Point, Point > >& aLines) const;
+			/**
+			 * The lock of the walls, their end points and their index. The GUI holds it while it changes
+			 * them, the other threads while they read them.
+			 */
+			std::recursive_mutex& getWallsMutex() const
+			{
+				return wallsMutex;
+			}
+			/**
+			 * Appends the walls that come within aRadius of aPoint to aWalls, looking only at the walls
+			 * near aPoint
+			 */
+			void getWallsNear(	const Point& aPoint,
+								int aRadius,
+								std::vector< WallPtr >& aWalls) const;
+			/**
+			 * Appends the walls that come within aRadius of the line from aPoint1 to aPoint2 to aWalls,
+			 * looking only at the walls near the line
+			 */
+			void getWallsNear(	const Point& aPoint1,
+								const Point& aPoint2,
+								int aRadius,
+								std::vector< WallPtr >& aWalls) const;
+			/**
+			 * Appends the walls that intersect the line from aPoint1 to aPoint2 to aWalls, looking only at
+			 * the walls near the line
+			 */
+			void getWallsAlong(	const Point& aPoint1,
+								const Point& aPoint2,
+								std::vector< WallPtr >& aWalls) const;
+			/**
+			 *
+			 * @return The revision of the walls, this changes whenever a wall is added, deleted or moved
+			 */
+			unsigned long getWallRevision() const;
+			/**
+			 * Called by a driving Robot after every step, even if the observers are not notified
+			 */
+			void robotMoved( const Robot& aRobot);
+			/**
+			 * Appends the other robots that overlap aRobot to aRobots, looking only at the robots near it
+			 */
+			void getCollidingRobots(	const Robot& aRobot,
+										std::vector< RobotPtr >& aRobots) const;
+			/**
+			 * Appends every pair of robots that overlap to aPairs
+			 */
+			void getCollidingRobots( std::vector< std::pair< RobotPtr, RobotPtr > >& aPairs) const;
+			/**
+			 * Called by a Wall if one of its end points is moved, even if the observers are not notified
+			 */
+			void wallChanged( 	const Wall& aWall,
+								const Point& anOldPoint1,
+								const Point& anOldPoint2);
+			/**
+			 * Gives the lines of all walls that changed after aRevision so that anything derived from the
+			 * walls can be updated locally instead of being rebuilt. Only the most recent changes are kept.
+			 *
+			 * @param aRevision A revision returned by getWallRevision
+			 * @param aChanges Receives the changes after aRevision, oldest first
+			 * @return false if the changes after aRevision are no longer known: consider everything changed
+			 */
+			bool getWallChangesSince( 	unsigned long aRevision,
+										std::vector< WallChange >& aChanges) const;
 			/**
 			 *
 			 */
@@ -218,6 +305,36 @@ namespace Model
 			mutable std::vector< WayPointPtr > wayPoints;
 			mutable std::vector< GoalPtr > goals;
 			mutable std::vector< WallPtr > walls;
+			/**
+			 * Adds a line to the wall change log and increments the wall revision
+			 */
+			void addWallChange( const Point& aPoint1,
+								const Point& aPoint2);
+
+			std::atomic< unsigned long > wallRevision;
+			/**
+			 * The changes after wallChangesBase
+			 */
+			std::deque< WallChange > wallChanges;
+			unsigned long wallChangesBase;
+			mutable std::mutex wallChangesMutex;
+			/**
+			 * The walls by position, the robots query it while the GUI edits the walls
+			 */
+			WallIndex wallIndex;
+			mutable std::recursive_mutex wallsMutex;
+			/**
+			 * The boxes of the robots, a robot updates its box while it drives in its own thread. The handle
+			 * of a robot in the broadphase is its index in robotsByHandle.
+			 */
+			mutable Broadphase robotBroadphase;
+			std::unordered_map< const Robot*, std::size_t > robotHandles;
+			std::vector< RobotPtr > robotsByHandle;
+			mutable std::mutex robotBroadphaseMutex;
+			/**
+			 *
+			 */
+			void removeFromBroadphase( const Robot& aRobot);
 
 			std::string localPort;
 			std::string remotePort;
@@ -87,6 +87,7 @@ namespace View
 	RobotWorldCanvas::~RobotWorldCanvas()
 	{
 		shapes.clear();
+		wallShapes.clear();
 
 		PopEventHandler();
 
@@ -361,41 +362,25 @@ namespace View
 	 */
 	bool RobotWorldCanvas::isShapeAt( const Point& aPoint) const
 	{
-		for (ShapePtr shape : shapes)
-		{
-			if (shape->occupies( aPoint))
-			{
-				return true;
-			}
-		}
-		return false;
+		return findShapeAt( aPoint) != nullptr;
 	}
 	/**
 	 *
 	 */
 	ShapePtr RobotWorldCanvas::getShapeAt( const Point& aPoint) const
 	{
-		for (ShapePtr shape : shapes)
-		{
-			if (shape->occupies( aPoint))
-			{
-				return shape;
-			}
-		}
-		return nullptr;
+		return findShapeAt( aPoint);
 	}
 	/**
 	 *
 	 */
 	bool RobotWorldCanvas::selectShapeAt( const Point& aPoint)
 	{
-		for (ShapePtr shape : shapes)
+		ShapePtr shape = findShapeAt( aPoint);
+		if (shape)
 		{
-			if (shape->occupies( aPoint))
-			{
-				setSelectedShape( shape);
-				return true;
-			}
+			setSelectedShape( shape);
+			return true;
 		}
 		return false;
 	}
@@ -446,6 +431,7 @@ namespace View
 	void RobotWorldCanvas::unpopulate()
 	{
 		shapes.clear();
+		wallShapes.clear();
 		Model::RobotWorld::getRobotWorld().unpopulate();
 	}
 
@@ -491,6 +477,33 @@ namespace View
 
 		handleNotificationsFor( Model::RobotWorld::getRobotWorld());
 	}
+	/**
+	 *
+	 */
+	ShapePtr RobotWorldCanvas::findShapeAt( const Point& aPoint) const
+	{
+		// The end points of the walls are RectangleShapes of their own and are found here
+		for (const ShapePtr& shape : shapes)
+		{
+			if (!shape->isWallShape() && shape->occupies( aPoint))
+			{
+				return shape;
+			}
+		}
+
+		// The radius of Shape2DUtils::isOnLine in WallShape::occupies
+		std::vector< Model::WallPtr > walls;
+		Model::RobotWorld::getRobotWorld().getWallsNear( aPoint, 2, walls);
+		for (Model::WallPtr wall : walls)
+		{
+			std::map< Base::ObjectId, WallShapePtr >::const_iterator wallShape = wallShapes.find( wall->getObjectId());
+			if (wallShape != wallShapes.end() && wallShape->second->occupies( aPoint))
+			{
+				return wallShape->second;
+			}
+		}
+		return nullptr;
+	}
 	/**
 	 *
 	 */
@@ -993,10 +1006,11 @@ namespace View
 		RectangleShapePtr start( new RectangleShape( popupPoint));
 		RectangleShapePtr end( new RectangleShape( popupPoint + Point( 50, 50)));
 
-		ShapePtr wall( new WallShape( Model::RobotWorld::getRobotWorld().newWall( start->getCentre(), end->getCentre(),false),
-									  start,
-									  end));
+		WallShapePtr wall( new WallShape( Model::RobotWorld::getRobotWorld().newWall( start->getCentre(), end->getCentre(),false),
+										  start,
+										  end));
 
+		wallShapes[wall->getWall()->getObjectId()] = wall;
 		shapes.push_back( wall);
 		shapes.push_back( start);
 		shapes.push_back( end);
@@ -1169,6 +1183,7 @@ namespace View
 		aWallShape->setNode1(start);
 		aWallShape->setNode2(end);
 
+		wallShapes[aWallShape->getWall()->getObjectId()] = aWallShape;
 		shapes.push_back( start);
 		shapes.push_back( end);
 		shapes.push_back( aWallShape);
@@ -1207,6 +1222,7 @@ namespace View
 	{
 		RectangleShapePtr start = aWallShape->hasEndPointAt( aWallShape->getBegin());
 		RectangleShapePtr end = aWallShape->hasEndPointAt( aWallShape->getEnd());
+		wallShapes.erase( aWallShape->getWall()->getObjectId());
 		Model::RobotWorld::getRobotWorld().deleteWall( aWallShape->getWall(), false);
 		removeGenericShape( aWallShape);
 		removeGenericShape( start);
@@ -2,6 +2,7 @@
 #define ROBOTWORLDCANVAS_HPP_
 
 #include "Config.hpp"
+#include <map>
 #include <vector>
 #include "Widgets.hpp"
 #include "ViewObject.hpp"
@@ -119,8 +120,9 @@ namespace View
 			/**
 			 *
 			 * @param 	aPoint A screen point, i.e. a point on the screen, not on the (scrollable) canvas.
-			 * @return 	The first Shape in iteration order that returns true for Shape.ocuppies(aPoint). If
-			 * 			no such Shape exists nullptr will be returned.
+			 * @return 	The first Shape in iteration order that returns true for Shape.ocuppies(aPoint), the
+			 * 			lines of the walls come after all other Shapes. If no such Shape exists nullptr will
+			 * 			be returned.
 			 */
 			virtual ShapePtr getShapeAt( const Point& aPoint) const;
 			/**
@@ -325,6 +327,15 @@ namespace View
 			//@}
 
 			std::vector< ShapePtr > shapes;
+			/**
+			 * The WallShapes by the ObjectId of their Wall. The hit test only looks at the lines of the walls
+			 * that RobotWorld finds near the point instead of at all walls.
+			 */
+			std::map< Base::ObjectId, WallShapePtr > wallShapes;
+			/**
+			 * The implementation of getShapeAt, selectShapeAt and isShapeAt
+			 */
+			ShapePtr findShapeAt( const Point& aPoint) const;
 
 			enum
 			{
@@ -0,0 +1,138 @@
+#include "SearchGrid.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	SearchGrid::SearchGrid() :
+								topLeft( 0, 0),
+								width( 0),
+								height( 0),
+								pageOrigin( 0, 0),
+								pagesPerRow( 0),
+								pagesPerColumn( 0),
+								generation( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	void SearchGrid::reset(	const Point& aTopLeft,
+							int aWidth,
+							int aHeight)
+	{
+		topLeft = aTopLeft;
+		width = aWidth;
+		height = aHeight;
+		if (width > 0 && height > 0)
+		{
+			growPages( getPage( topLeft.x), getPage( topLeft.y), getPage( topLeft.x + width - 1), getPage( topLeft.y + height - 1));
+		}
+
+		++generation;
+		if (generation == 0)
+		{
+			// The generation wrapped: really clear the pages once every 2^32 searches
+			for (std::unique_ptr< Page >& page : pages)
+			{
+				if (page)
+				{
+					page->generation = 0;
+				}
+			}
+			generation = 1;
+		}
+	}
+	/**
+	 *
+	 */
+	Point SearchGrid::pointOf( std::uint32_t anIndex) const
+	{
+		std::uint32_t page = anIndex >> (2 * PageBits);
+		std::uint32_t offset = anIndex & (PageCells - 1);
+		int column = static_cast< int >( (page % pagesPerRow) * PageSize + (offset & PageMask));
+		int row = static_cast< int >( (page / pagesPerRow) * PageSize + (offset >> PageBits));
+		return Point( pageOrigin.x + column, pageOrigin.y + row);
+	}
+	/**
+	 *
+	 */
+	std::size_t SearchGrid::getAllocatedSize() const
+	{
+		std::size_t size = 0;
+		for (const std::unique_ptr< Page >& page : pages)
+		{
+			if (page)
+			{
+				size += sizeof(Page);
+			}
+		}
+		return size;
+	}
+	/**
+	 *
+	 */
+	void SearchGrid::growPages(	int aFirstColumn,
+								int aFirstRow,
+								int aLastColumn,
+								int aLastRow)
+	{
+		int firstColumn = pageOrigin.x / static_cast< int >( PageSize);
+		int firstRow = pageOrigin.y / static_cast< int >( PageSize);
+		int lastColumn = firstColumn + static_cast< int >( pagesPerRow) - 1;
+		int lastRow = firstRow + static_cast< int >( pagesPerColumn) - 1;
+		if (pages.empty())
+		{
+			firstColumn = aFirstColumn;
+			firstRow = aFirstRow;
+			lastColumn = aLastColumn;
+			lastRow = aLastRow;
+		} else if (aFirstColumn >= firstColumn && aFirstRow >= firstRow && aLastColumn <= lastColumn && aLastRow <= lastRow)
+		{
+			return;
+		} else
+		{
+			firstColumn = std::min( firstColumn, aFirstColumn);
+			firstRow = std::min( firstRow, aFirstRow);
+			lastColumn = std::max( lastColumn, aLastColumn);
+			lastRow = std::max( lastRow, aLastRow);
+		}
+
+		std::uint32_t newPagesPerRow = static_cast< std::uint32_t >( lastColumn - firstColumn + 1);
+		std::uint32_t newPagesPerColumn = static_cast< std::uint32_t >( lastRow - firstRow + 1);
+		std::vector< std::unique_ptr< Page > > newPages( newPagesPerRow * newPagesPerColumn);
+		for (std::uint32_t page = 0; page < pages.size(); ++page)
+		{
+			if (pages[page])
+			{
+				std::uint32_t column = page % pagesPerRow + static_cast< std::uint32_t >( pageOrigin.x / static_cast< int >( PageSize) - firstColumn);
+				std::uint32_t row = page / pagesPerRow + static_cast< std::uint32_t >( pageOrigin.y / static_cast< int >( PageSize) - firstRow);
+				newPages[row * newPagesPerRow + column] = std::move( pages[page]);
+			}
+		}
+		pages.swap( newPages);
+		pageOrigin = Point( firstColumn * static_cast< int >( PageSize), firstRow * static_cast< int >( PageSize));
+		pagesPerRow = newPagesPerRow;
+		pagesPerColumn = newPagesPerColumn;
+	}
+	/**
+	 *
+	 */
+	void SearchGrid::allocatePage( std::unique_ptr< Page >& aPage)
+	{
+		aPage.reset( new Page);
+		aPage->generation = 0;
+	}
+	/**
+	 *
+	 */
+	void SearchGrid::clearPage( Page& aPage)
+	{
+		std::memset( aPage.state, Unvisited, sizeof(aPage.state));
+		aPage.generation = generation;
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,213 @@
+#ifndef SEARCHGRID_HPP_
+#define SEARCHGRID_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "Point.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The SearchGrid holds the per cell state of a grid search (cost, predecessor, open/closed) for a
+	 * bounded, rectangular area. It replaces the node based closed set and predecessor map.
+	 *
+	 * The cells are stored in pages of PageSize x PageSize cells that are only allocated when a search
+	 * touches them and that are kept for the next search. The pages lie on multiples of PageSize in
+	 * world coordinates, so a page covers the same cells whatever the area of the search, and the pages
+	 * only ever grow to hold the areas of all searches so far. A search does not clear the pages: every
+	 * page carries the generation of the search that last wrote it and only the states of a page of an
+	 * older generation are cleared when the page is touched. A search in an area that fits the areas
+	 * of the previous searches therefore does not allocate.
+	 *
+	 * A page stores every field of its cells in a separate array, so a search that only reads the
+	 * states, as the closed set test does, only loads the states: 13 bytes per cell of which one is
+	 * read most.
+	 *
+	 * A cell index is page major: the page number followed by the offset in the page, so that
+	 * looking up a cell is a shift and a mask instead of a division.
+	 */
+	class SearchGrid : private boost::noncopyable
+	{
+		public:
+			/**
+			 *
+			 */
+			enum CellState
+			{
+				Unvisited,
+				Open,
+				Closed,
+				/**
+				 * The cell has a cost but is neither open nor closed, see AnytimeAStar
+				 */
+				Reached
+			};
+			/**
+			 * The fields of one cell, which are stored in the separate arrays of its page. Only the state
+			 * of an unvisited cell is valid, the other fields must be written before they are read.
+			 */
+			struct Cell
+			{
+					/**
+					 * Fixed point, see PathAlgorithm::Cost
+					 */
+					std::uint32_t& actualCost;
+					std::uint32_t& parent;
+					std::uint32_t& heapSlot;
+					std::uint8_t& state;
+			};
+			/**
+			 * The parent of a cell without a predecessor
+			 */
+			static const std::uint32_t NoCell = 0xFFFFFFFF;
+			/**
+			 *
+			 */
+			SearchGrid();
+			/**
+			 * Starts a new search in the area with the given top left corner and size, all cells become
+			 * unvisited. The pages are kept, if the area does not fit the pages they grow to hold it.
+			 */
+			void reset(	const Point& aTopLeft,
+						int aWidth,
+						int aHeight);
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= topLeft.x && anY >= topLeft.y && anX < topLeft.x + width && anY < topLeft.y + height;
+			}
+			/**
+			 *
+			 * @return The index of the cell at (anX,anY), which must be in the area
+			 */
+			std::uint32_t indexOf(	int anX,
+									int anY) const
+			{
+				std::uint32_t column = static_cast< std::uint32_t >( anX - pageOrigin.x);
+				std::uint32_t row = static_cast< std::uint32_t >( anY - pageOrigin.y);
+				std::uint32_t page = (row >> PageBits) * pagesPerRow + (column >> PageBits);
+				return (page << (2 * PageBits)) | ((row & PageMask) << PageBits) | (column & PageMask);
+			}
+			/**
+			 *
+			 * @return The coordinates of the cell with the given index
+			 */
+			Point pointOf( std::uint32_t anIndex) const;
+			/**
+			 *
+			 * @return The cell for the current search, allocates its page if needed
+			 */
+			Cell at( std::uint32_t anIndex)
+			{
+				std::unique_ptr< Page >& page = pages[anIndex >> (2 * PageBits)];
+				if (!page)
+				{
+					allocatePage( page);
+				}
+				if (page->generation != generation)
+				{
+					clearPage( *page);
+				}
+				std::uint32_t offset = anIndex & (PageCells - 1);
+				Cell cell = { page->actualCost[offset], page->parent[offset], page->heapSlot[offset], page->state[offset] };
+				return cell;
+			}
+			/**
+			 *
+			 * @return The state of the cell in the current search, Unvisited if it was not written
+			 */
+			CellState getState( std::uint32_t anIndex) const
+			{
+				const std::unique_ptr< Page >& page = pages[anIndex >> (2 * PageBits)];
+				if (!page || page->generation != generation)
+				{
+					return Unvisited;
+				}
+				return static_cast< CellState >( page->state[anIndex & (PageCells - 1)]);
+			}
+			/**
+			 *
+			 * @return The cost of a cell that is not Unvisited
+			 */
+			std::uint32_t getActualCost( std::uint32_t anIndex) const
+			{
+				return pages[anIndex >> (2 * PageBits)]->actualCost[anIndex & (PageCells - 1)];
+			}
+			/**
+			 *
+			 * @return The predecessor of a cell that is not Unvisited
+			 */
+			std::uint32_t getParent( std::uint32_t anIndex) const
+			{
+				return pages[anIndex >> (2 * PageBits)]->parent[anIndex & (PageCells - 1)];
+			}
+			/**
+			 *
+			 * @return The number of bytes allocated for cells
+			 */
+			std::size_t getAllocatedSize() const;
+
+		private:
+			static const int PageBits = 5;
+			static const std::uint32_t PageSize = 1 << PageBits;
+			static const std::uint32_t PageMask = PageSize - 1;
+			static const std::uint32_t PageCells = PageSize * PageSize;
+			/**
+			 *
+			 */
+			struct Page
+			{
+					std::uint32_t generation;
+					std::uint8_t state[PageCells];
+					std::uint32_t actualCost[PageCells];
+					std::uint32_t parent[PageCells];
+					std::uint32_t heapSlot[PageCells];
+			};
+			/**
+			 *
+			 * @return The row or column of the page that holds aCoordinate
+			 */
+			static int getPage( int aCoordinate)
+			{
+				// Round towards minus infinity, the area may have negative coordinates
+				return aCoordinate >= 0 ? aCoordinate / static_cast< int >( PageSize) : -((-aCoordinate - 1) / static_cast< int >( PageSize)) - 1;
+			}
+			/**
+			 * Grows the pages to hold the pages from aFirstColumn to aLastColumn and from aFirstRow to
+			 * aLastRow as well as the ones they hold, the allocated pages move to their new index
+			 */
+			void growPages(	int aFirstColumn,
+							int aFirstRow,
+							int aLastColumn,
+							int aLastRow);
+			/**
+			 *
+			 */
+			void allocatePage( std::unique_ptr< Page >& aPage);
+			/**
+			 * Makes all cells of aPage unvisited in the current search
+			 */
+			void clearPage( Page& aPage);
+
+			Point topLeft;
+			int width;
+			int height;
+			/**
+			 * The top left corner of the first page, a multiple of PageSize
+			 */
+			Point pageOrigin;
+			std::uint32_t pagesPerRow;
+			std::uint32_t pagesPerColumn;
+			std::uint32_t generation;
+			std::vector< std::unique_ptr< Page > > pages;
+	}; // class SearchGrid
+} // namespace PathAlgorithm
+#endif // SEARCHGRID_HPP_
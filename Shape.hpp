@@ -101,6 +101,15 @@ namespace View
 			 */
 			virtual void setCentre( const Point& aPoint) = 0;
 			//@}
+			/**
+			 *
+			 * @return True for a WallShape, RobotWorldCanvas finds those through the walls near a point
+			 * 		   instead of in its list of shapes
+			 */
+			virtual bool isWallShape() const
+			{
+				return false;
+			}
 			/**
 			 * @name Accessors and mutators
 			 */
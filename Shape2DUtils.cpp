@@ -1,6 +1,9 @@
 #include "Shape2DUtils.hpp"
 #include <sstream>
 #include <algorithm>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 #include "Widgets.hpp"
 
 namespace Utils
@@ -81,6 +84,20 @@ namespace Utils
 
 		return true;
 	}
+	/**
+	 *
+	 */
+	/* static */void Shape2DUtils::intersect(	const Point& aStartLine,
+												const Point& anEndLine,
+												const Segments& aSegments,
+												std::vector< std::size_t >& anIndices)
+	{
+		for (std::size_t i = findIntersection( aStartLine.x, aStartLine.y, anEndLine.x, anEndLine.y, aSegments, 0); i < aSegments.size();
+			 i = findIntersection( aStartLine.x, aStartLine.y, anEndLine.x, anEndLine.y, aSegments, i + 1))
+		{
+			anIndices.push_back( i);
+		}
+	}
 	/**
 	 *
 	 */
@@ -363,6 +380,106 @@ namespace Utils
 	{
 		return (anX * sin( anAngle) + anY * cos( anAngle));
 	}
+	/**
+	 * With a line from a to b and a segment from c to d the sign of the cross product (b - a) x (c - a)
+	 * tells on which side of the line c is. For coordinates that fit in 16 bits, as in a Path, the cross
+	 * products are exact in a double.
+	 */
+	/* static */std::size_t Shape2DUtils::findIntersection(	double aStartX,
+															double aStartY,
+															double anEndX,
+															double anEndY,
+															const Segments& aSegments,
+															std::size_t aFirst)
+	{
+		const double lineX = anEndX - aStartX;
+		const double lineY = anEndY - aStartY;
+		const std::size_t size = aSegments.size();
+		std::size_t i = aFirst;
+
+#if defined(__AVX__)
+		const __m256d ax = _mm256_set1_pd( aStartX);
+		const __m256d ay = _mm256_set1_pd( aStartY);
+		const __m256d bx = _mm256_set1_pd( anEndX);
+		const __m256d by = _mm256_set1_pd( anEndY);
+		const __m256d ex = _mm256_set1_pd( lineX);
+		const __m256d ey = _mm256_set1_pd( lineY);
+		const __m256d zero = _mm256_setzero_pd();
+		for (; i + 4 <= size; i += 4)
+		{
+			__m256d cx = _mm256_loadu_pd( &aSegments.startX[i]);
+			__m256d cy = _mm256_loadu_pd( &aSegments.startY[i]);
+			__m256d dx = _mm256_loadu_pd( &aSegments.endX[i]);
+			__m256d dy = _mm256_loadu_pd( &aSegments.endY[i]);
+			__m256d fx = _mm256_sub_pd( dx, cx);
+			__m256d fy = _mm256_sub_pd( dy, cy);
+
+			__m256d o1 = _mm256_sub_pd( _mm256_mul_pd( ex, _mm256_sub_pd( cy, ay)), _mm256_mul_pd( ey, _mm256_sub_pd( cx, ax)));
+			__m256d o2 = _mm256_sub_pd( _mm256_mul_pd( ex, _mm256_sub_pd( dy, ay)), _mm256_mul_pd( ey, _mm256_sub_pd( dx, ax)));
+			__m256d o3 = _mm256_sub_pd( _mm256_mul_pd( fx, _mm256_sub_pd( ay, cy)), _mm256_mul_pd( fy, _mm256_sub_pd( ax, cx)));
+			__m256d o4 = _mm256_sub_pd( _mm256_mul_pd( fx, _mm256_sub_pd( by, cy)), _mm256_mul_pd( fy, _mm256_sub_pd( bx, cx)));
+			__m256d parallel = _mm256_sub_pd( _mm256_mul_pd( ex, fy), _mm256_mul_pd( ey, fx));
+
+			__m256d hit = _mm256_and_pd( _mm256_cmp_pd( _mm256_mul_pd( o1, o2), zero, _CMP_LE_OQ), _mm256_cmp_pd( _mm256_mul_pd( o3, o4), zero, _CMP_LE_OQ));
+			hit = _mm256_and_pd( hit, _mm256_cmp_pd( parallel, zero, _CMP_NEQ_OQ));
+			int mask = _mm256_movemask_pd( hit);
+			if (mask != 0)
+			{
+				return i + static_cast< std::size_t >( __builtin_ctz( static_cast< unsigned >( mask)));
+			}
+		}
+#elif defined(__SSE2__)
+		const __m128d ax = _mm_set1_pd( aStartX);
+		const __m128d ay = _mm_set1_pd( aStartY);
+		const __m128d bx = _mm_set1_pd( anEndX);
+		const __m128d by = _mm_set1_pd( anEndY);
+		const __m128d ex = _mm_set1_pd( lineX);
+		const __m128d ey = _mm_set1_pd( lineY);
+		const __m128d zero = _mm_setzero_pd();
+		for (; i + 2 <= size; i += 2)
+		{
+			__m128d cx = _mm_loadu_pd( &aSegments.startX[i]);
+			__m128d cy = _mm_loadu_pd( &aSegments.startY[i]);
+			__m128d dx = _mm_loadu_pd( &aSegments.endX[i]);
+			__m128d dy = _mm_loadu_pd( &aSegments.endY[i]);
+			__m128d fx = _mm_sub_pd( dx, cx);
+			__m128d fy = _mm_sub_pd( dy, cy);
+
+			__m128d o1 = _mm_sub_pd( _mm_mul_pd( ex, _mm_sub_pd( cy, ay)), _mm_mul_pd( ey, _mm_sub_pd( cx, ax)));
+			__m128d o2 = _mm_sub_pd( _mm_mul_pd( ex, _mm_sub_pd( dy, ay)), _mm_mul_pd( ey, _mm_sub_pd( dx, ax)));
+			__m128d o3 = _mm_sub_pd( _mm_mul_pd( fx, _mm_sub_pd( ay, cy)), _mm_mul_pd( fy, _mm_sub_pd( ax, cx)));
+			__m128d o4 = _mm_sub_pd( _mm_mul_pd( fx, _mm_sub_pd( by, cy)), _mm_mul_pd( fy, _mm_sub_pd( bx, cx)));
+			__m128d parallel = _mm_sub_pd( _mm_mul_pd( ex, fy), _mm_mul_pd( ey, fx));
+
+			__m128d hit = _mm_and_pd( _mm_cmple_pd( _mm_mul_pd( o1, o2), zero), _mm_cmple_pd( _mm_mul_pd( o3, o4), zero));
+			hit = _mm_and_pd( hit, _mm_cmpneq_pd( parallel, zero));
+			int mask = _mm_movemask_pd( hit);
+			if (mask != 0)
+			{
+				return i + ((mask & 1) ? 0 : 1);
+			}
+		}
+#endif
+		// The remainder, or all segments without vector instructions
+		for (; i < size; ++i)
+		{
+			double cx = aSegments.startX[i];
+			double cy = aSegments.startY[i];
+			double fx = aSegments.endX[i] - cx;
+			double fy = aSegments.endY[i] - cy;
+
+			double o1 = lineX * (cy - aStartY) - lineY * (cx - aStartX);
+			double o2 = lineX * (aSegments.endY[i] - aStartY) - lineY * (aSegments.endX[i] - aStartX);
+			double o3 = fx * (aStartY - cy) - fy * (aStartX - cx);
+			double o4 = fx * (anEndY - cy) - fy * (anEndX - cx);
+
+			if (o1 * o2 <= 0.0 && o3 * o4 <= 0.0 && lineX * fy - lineY * fx != 0.0)
+			{
+				return i;
+			}
+		}
+		return size;
+	}
 	/**
 	 *
 	 */
@@ -2,7 +2,9 @@
 #define SHAPE2DUTILS_HPP_
 
 #include "Config.hpp"
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "BoundedVector.hpp"
 #include "MathUtils.hpp"
@@ -11,6 +13,70 @@
 
 namespace Utils
 {
+	/**
+	 * Line segments for the batched intersect functions of Shape2DUtils. The coordinates are stored as
+	 * four arrays, one per coordinate of the end points, so that a vector instruction loads the same
+	 * coordinate of several segments at once.
+	 */
+	class Segments
+	{
+		public:
+			/**
+			 *
+			 */
+			void push_back(	const Point& aStartPoint,
+							const Point& anEndPoint)
+			{
+				startX.push_back( aStartPoint.x);
+				startY.push_back( aStartPoint.y);
+				endX.push_back( anEndPoint.x);
+				endY.push_back( anEndPoint.y);
+			}
+			/**
+			 *
+			 */
+			std::size_t size() const
+			{
+				return startX.size();
+			}
+			/**
+			 *
+			 */
+			bool empty() const
+			{
+				return startX.empty();
+			}
+			/**
+			 *
+			 */
+			void reserve( std::size_t aSize)
+			{
+				startX.reserve( aSize);
+				startY.reserve( aSize);
+				endX.reserve( aSize);
+				endY.reserve( aSize);
+			}
+			/**
+			 *
+			 */
+			void clear()
+			{
+				startX.clear();
+				startY.clear();
+				endX.clear();
+				endY.clear();
+			}
+
+		private:
+			friend class Shape2DUtils;
+
+			std::vector< double > startX;
+			std::vector< double > startY;
+			std::vector< double > endX;
+			std::vector< double > endY;
+	};
+	//	class Segments
+
 	/**
 	 *
 	 */
@@ -40,6 +106,18 @@ namespace Utils
 											const Point& aEndLine1,
 											const Point& aStartLine2,
 											const Point& anEndLine2);
+			/**
+			 * Tests the line from aStartLine to anEndLine against all segments of aSegments, several at a
+			 * time with AVX or SSE2 if the compiler targets them and one at a time otherwise. There is no
+			 * division: two segments intersect if neither has its end points strictly on the same side of
+			 * the other. As with intersect(...) touching segments intersect and parallel segments do not.
+			 *
+			 * @param anIndices Receives the indices in aSegments of the segments that intersect the line
+			 */
+			static void intersect(	const Point& aStartLine,
+									const Point& anEndLine,
+									const Segments& aSegments,
+									std::vector< std::size_t >& anIndices);
 			/**
 			 *
 			 * @param aPolygon The array of points
@@ -133,6 +211,17 @@ namespace Utils
 			static std::string asString( const Size& aSize);
 
 		protected:
+			/**
+			 *
+			 * @return The index of the first segment of aSegments from aFirst on that intersects the line
+			 * 			from (aStartX,aStartY) to (anEndX,anEndY), aSegments.size() if there is none
+			 */
+			static std::size_t findIntersection(	double aStartX,
+													double aStartY,
+													double anEndX,
+													double anEndY,
+													const Segments& aSegments,
+													std::size_t aFirst);
 			static double rotateX(	const Point& aPoint,
 									double anAngle);
 			static double rotateY(	const Point& aPoint,
@@ -1,6 +1,8 @@
 #include "Wall.hpp"
+#include <mutex>
 #include <sstream>
 #include "Logger.hpp"
+#include "RobotWorld.hpp"
 #include "Shape2DUtils.hpp"
 
 namespace Model
@@ -32,7 +34,13 @@ namespace Model
 	void Wall::setPoint1(	const Point& aPoint1,
 							bool aNotifyObservers /*= true*/)
 	{
-		point1 = aPoint1;
+		{
+			// The planners and the robots read the end points on their own threads
+			std::lock_guard< std::recursive_mutex > lock( RobotWorld::getRobotWorld().getWallsMutex());
+			Point oldPoint1 = point1;
+			point1 = aPoint1;
+			RobotWorld::getRobotWorld().wallChanged( *this, oldPoint1, point2);
+		}
 		if (aNotifyObservers == true)
 		{
 			notifyObservers();
@@ -44,7 +52,13 @@ namespace Model
 	void Wall::setPoint2(	const Point& aPoint2,
 							bool aNotifyObservers /*= true*/)
 	{
-		point2 = aPoint2;
+		{
+			// The planners and the robots read the end points on their own threads
+			std::lock_guard< std::recursive_mutex > lock( RobotWorld::getRobotWorld().getWallsMutex());
+			Point oldPoint2 = point2;
+			point2 = aPoint2;
+			RobotWorld::getRobotWorld().wallChanged( *this, point1, oldPoint2);
+		}
 		if (aNotifyObservers == true)
 		{
 			notifyObservers();
@@ -0,0 +1,285 @@
+#include "WallIndex.hpp"
+#include <algorithm>
+#include <cmath>
+#include "Shape2DUtils.hpp"
+#include "Wall.hpp"
+
+namespace Model
+{
+	/**
+	 *
+	 */
+	WallIndex::WallIndex( int aBucketSize /*= DefaultBucketSize*/) :
+								bucketSize( aBucketSize),
+								numberOfWalls( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	void WallIndex::insert( WallPtr aWall)
+	{
+		forEachBucket( aWall->getPoint1(), aWall->getPoint2(), 0, [this, aWall]( std::uint64_t aKey)
+					   {
+							buckets[aKey].push_back( aWall);
+					   });
+		++numberOfWalls;
+	}
+	/**
+	 *
+	 */
+	WallPtr WallIndex::remove(	const Wall& aWall,
+								const Point& aPoint1,
+								const Point& aPoint2)
+	{
+		WallPtr removed;
+		forEachBucket( aPoint1, aPoint2, 0, [this, &aWall, &removed]( std::uint64_t aKey)
+					   {
+							std::unordered_map< std::uint64_t, Bucket >::iterator bucket = buckets.find( aKey);
+							if (bucket == buckets.end())
+							{
+								return;
+							}
+							Bucket::iterator i = std::find_if( bucket->second.begin(), bucket->second.end(), [&aWall]( const WallPtr& w)
+												   {
+														return w.get() == &aWall;
+												   });
+							if (i != bucket->second.end())
+							{
+								removed = *i;
+								bucket->second.erase( i);
+								if (bucket->second.empty())
+								{
+									buckets.erase( bucket);
+								}
+							}
+					   });
+		if (removed)
+		{
+			--numberOfWalls;
+		}
+		return removed;
+	}
+	/**
+	 *
+	 */
+	void WallIndex::move(	const Wall& aWall,
+							const Point& anOldPoint1,
+							const Point& anOldPoint2)
+	{
+		WallPtr wall = remove( aWall, anOldPoint1, anOldPoint2);
+		if (wall)
+		{
+			insert( wall);
+		}
+	}
+	/**
+	 *
+	 */
+	void WallIndex::clear()
+	{
+		buckets.clear();
+		numberOfWalls = 0;
+	}
+	/**
+	 *
+	 */
+	void WallIndex::getWallsNear(	const Point& aPoint,
+									int aRadius,
+									std::vector< WallPtr >& aWalls) const
+	{
+		std::size_t first = aWalls.size();
+		collect( aPoint, aPoint, aRadius, aWalls);
+
+		double squaredRadius = static_cast< double >( aRadius) * aRadius;
+		aWalls.erase( std::remove_if( aWalls.begin() + static_cast< std::ptrdiff_t >( first), aWalls.end(), [&aPoint, squaredRadius]( const WallPtr& aWall)
+									  {
+											return getSquaredDistance( aPoint, aWall->getPoint1(), aWall->getPoint2()) > squaredRadius;
+									  }),
+					  aWalls.end());
+	}
+	/**
+	 *
+	 */
+	void WallIndex::getWallsNear(	const Point& aPoint1,
+									const Point& aPoint2,
+									int aRadius,
+									std::vector< WallPtr >& aWalls) const
+	{
+		std::size_t first = aWalls.size();
+		collect( aPoint1, aPoint2, aRadius, aWalls);
+
+		double squaredRadius = static_cast< double >( aRadius) * aRadius;
+		aWalls.erase( std::remove_if( aWalls.begin() + static_cast< std::ptrdiff_t >( first), aWalls.end(), [&aPoint1, &aPoint2, squaredRadius]( const WallPtr& aWall)
+									  {
+											return getSquaredDistance( aPoint1, aPoint2, aWall->getPoint1(), aWall->getPoint2()) > squaredRadius;
+									  }),
+					  aWalls.end());
+	}
+	/**
+	 *
+	 */
+	void WallIndex::getWallsAlong(	const Point& aPoint1,
+									const Point& aPoint2,
+									std::vector< WallPtr >& aWalls) const
+	{
+		std::size_t first = aWalls.size();
+		collect( aPoint1, aPoint2, 0, aWalls);
+
+		// The candidates are tested in one batch, several walls per vector instruction
+		Utils::Segments lines;
+		lines.reserve( aWalls.size() - first);
+		for (std::size_t i = first; i < aWalls.size(); ++i)
+		{
+			lines.push_back( aWalls[i]->getPoint1(), aWalls[i]->getPoint2());
+		}
+		std::vector< std::size_t > indices;
+		Utils::Shape2DUtils::intersect( aPoint1, aPoint2, lines, indices);
+
+		// The indices ascend, every wall moves to the front or stays
+		for (std::size_t i = 0; i < indices.size(); ++i)
+		{
+			aWalls[first + i] = aWalls[first + indices[i]];
+		}
+		aWalls.resize( first + indices.size());
+	}
+	/**
+	 *
+	 */
+	int WallIndex::getBucket( int aCoordinate) const
+	{
+		// Round towards minus infinity, the world may have negative coordinates
+		return aCoordinate >= 0 ? aCoordinate / bucketSize : -((-aCoordinate - 1) / bucketSize) - 1;
+	}
+	/**
+	 *
+	 */
+	void WallIndex::forEachBucket(	const Point& aPoint1,
+									const Point& aPoint2,
+									int aMargin,
+									const std::function< void( std::uint64_t) >& aVisitor) const
+	{
+		int left = getBucket( std::min( aPoint1.x, aPoint2.x) - aMargin);
+		int right = getBucket( std::max( aPoint1.x, aPoint2.x) + aMargin);
+		int top = getBucket( std::min( aPoint1.y, aPoint2.y) - aMargin);
+		int bottom = getBucket( std::max( aPoint1.y, aPoint2.y) + aMargin);
+
+		for (int row = top; row <= bottom; ++row)
+		{
+			for (int column = left; column <= right; ++column)
+			{
+				// A diagonal line only passes through the buckets near the diagonal of its bounding box
+				if (left == right || top == bottom ||
+					crosses(	aPoint1,
+								aPoint2,
+								static_cast< double >( column) * bucketSize - aMargin,
+								static_cast< double >( row) * bucketSize - aMargin,
+								static_cast< double >( column + 1) * bucketSize + aMargin,
+								static_cast< double >( row + 1) * bucketSize + aMargin))
+				{
+					aVisitor( getKey( column, row));
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void WallIndex::collect(	const Point& aPoint1,
+								const Point& aPoint2,
+								int aMargin,
+								std::vector< WallPtr >& aWalls) const
+	{
+		std::size_t first = aWalls.size();
+		forEachBucket( aPoint1, aPoint2, aMargin, [this, &aWalls]( std::uint64_t aKey)
+					   {
+							std::unordered_map< std::uint64_t, Bucket >::const_iterator bucket = buckets.find( aKey);
+							if (bucket != buckets.end())
+							{
+								aWalls.insert( aWalls.end(), bucket->second.begin(), bucket->second.end());
+							}
+					   });
+
+		// A wall that passes through more than one of the buckets is in each of them
+		std::sort( aWalls.begin() + static_cast< std::ptrdiff_t >( first), aWalls.end());
+		aWalls.erase( std::unique( aWalls.begin() + static_cast< std::ptrdiff_t >( first), aWalls.end()), aWalls.end());
+	}
+	/**
+	 *
+	 */
+	/* static */bool WallIndex::crosses(	const Point& aPoint1,
+										const Point& aPoint2,
+										double aLeft,
+										double aTop,
+										double aRight,
+										double aBottom)
+	{
+		double dx = aPoint2.x - aPoint1.x;
+		double dy = aPoint2.y - aPoint1.y;
+		double p[] = { -dx, dx, -dy, dy };
+		double q[] = { aPoint1.x - aLeft, aRight - aPoint1.x, aPoint1.y - aTop, aBottom - aPoint1.y };
+
+		double enter = 0.0;
+		double leave = 1.0;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (p[i] == 0.0)
+			{
+				if (q[i] < 0.0)
+				{
+					return false;
+				}
+			} else
+			{
+				double t = q[i] / p[i];
+				if (p[i] < 0.0)
+				{
+					enter = std::max( enter, t);
+				} else
+				{
+					leave = std::min( leave, t);
+				}
+			}
+		}
+		return enter <= leave;
+	}
+	/**
+	 *
+	 */
+	/* static */double WallIndex::getSquaredDistance(	const Point& aPoint,
+													const Point& aPoint1,
+													const Point& aPoint2)
+	{
+		double dx = aPoint2.x - aPoint1.x;
+		double dy = aPoint2.y - aPoint1.y;
+		double length = dx * dx + dy * dy;
+		double t = 0.0;
+		if (length > 0.0)
+		{
+			t = std::max( 0.0, std::min( 1.0, ((aPoint.x - aPoint1.x) * dx + (aPoint.y - aPoint1.y) * dy) / length));
+		}
+		double x = aPoint1.x + t * dx - aPoint.x;
+		double y = aPoint1.y + t * dy - aPoint.y;
+		return x * x + y * y;
+	}
+	/**
+	 *
+	 */
+	/* static */double WallIndex::getSquaredDistance(	const Point& aPoint1,
+													const Point& aPoint2,
+													const Point& aPoint3,
+													const Point& aPoint4)
+	{
+		double side1 = static_cast< double >( aPoint2.x - aPoint1.x) * (aPoint3.y - aPoint1.y) - static_cast< double >( aPoint2.y - aPoint1.y) * (aPoint3.x - aPoint1.x);
+		double side2 = static_cast< double >( aPoint2.x - aPoint1.x) * (aPoint4.y - aPoint1.y) - static_cast< double >( aPoint2.y - aPoint1.y) * (aPoint4.x - aPoint1.x);
+		double side3 = static_cast< double >( aPoint4.x - aPoint3.x) * (aPoint1.y - aPoint3.y) - static_cast< double >( aPoint4.y - aPoint3.y) * (aPoint1.x - aPoint3.x);
+		double side4 = static_cast< double >( aPoint4.x - aPoint3.x) * (aPoint2.y - aPoint3.y) - static_cast< double >( aPoint4.y - aPoint3.y) * (aPoint2.x - aPoint3.x);
+		if (((side1 < 0.0 && side2 > 0.0) || (side1 > 0.0 && side2 < 0.0)) && ((side3 < 0.0 && side4 > 0.0) || (side3 > 0.0 && side4 < 0.0)))
+		{
+			return 0.0;
+		}
+		// Otherwise the closest points include an end point, also if the lines touch
+		return std::min(	std::min( getSquaredDistance( aPoint1, aPoint3, aPoint4), getSquaredDistance( aPoint2, aPoint3, aPoint4)),
+							std::min( getSquaredDistance( aPoint3, aPoint1, aPoint2), getSquaredDistance( aPoint4, aPoint1, aPoint2)));
+	}
+} // namespace Model
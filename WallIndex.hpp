@@ -0,0 +1,157 @@
+#ifndef WALLINDEX_HPP_
+#define WALLINDEX_HPP_
+
+#include "Config.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "Point.hpp"
+
+namespace Model
+{
+	class Wall;
+	typedef std::shared_ptr<Wall> WallPtr;
+
+	/**
+	 * The WallIndex is a uniform grid of square buckets over the world. A wall is put in every bucket
+	 * its line passes through, so a query only looks at the walls in the buckets around the point or
+	 * line it asks for instead of at all walls. Only buckets that hold a wall are stored, the world has
+	 * no fixed size.
+	 *
+	 * The index does not lock, RobotWorld serialises the changes and the queries.
+	 */
+	class WallIndex : private boost::noncopyable
+	{
+		public:
+			/**
+			 * Large enough for most walls to fall in a few buckets and small enough for a query around a
+			 * robot to look at only a few buckets
+			 */
+			static const int DefaultBucketSize = 64;
+			/**
+			 *
+			 */
+			explicit WallIndex( int aBucketSize = DefaultBucketSize);
+			/**
+			 *
+			 */
+			void insert( WallPtr aWall);
+			/**
+			 * Removes aWall from the buckets of the line from aPoint1 to aPoint2, the line the wall had when
+			 * it was inserted or last moved
+			 *
+			 * @return The removed wall, nullptr if aWall was not in the index
+			 */
+			WallPtr remove(	const Wall& aWall,
+							const Point& aPoint1,
+							const Point& aPoint2);
+			/**
+			 * Moves aWall from the buckets of the line from anOldPoint1 to anOldPoint2 to the buckets of
+			 * its current line. Does nothing if aWall is not in the index.
+			 */
+			void move(	const Wall& aWall,
+						const Point& anOldPoint1,
+						const Point& anOldPoint2);
+			/**
+			 *
+			 */
+			void clear();
+			/**
+			 * Appends the walls that come within aRadius of aPoint to aWalls, every wall once
+			 */
+			void getWallsNear(	const Point& aPoint,
+								int aRadius,
+								std::vector< WallPtr >& aWalls) const;
+			/**
+			 * Appends the walls that come within aRadius of the line from aPoint1 to aPoint2 to aWalls,
+			 * every wall once
+			 */
+			void getWallsNear(	const Point& aPoint1,
+								const Point& aPoint2,
+								int aRadius,
+								std::vector< WallPtr >& aWalls) const;
+			/**
+			 * Appends the walls that intersect the line from aPoint1 to aPoint2 to aWalls, every wall once
+			 */
+			void getWallsAlong(	const Point& aPoint1,
+								const Point& aPoint2,
+								std::vector< WallPtr >& aWalls) const;
+			/**
+			 *
+			 * @return The number of walls in the index
+			 */
+			std::size_t size() const
+			{
+				return numberOfWalls;
+			}
+
+		private:
+			typedef std::vector< WallPtr > Bucket;
+			/**
+			 *
+			 */
+			std::uint64_t getKey(	int aColumn,
+									int aRow) const
+			{
+				return static_cast< std::uint64_t >( static_cast< std::uint32_t >( aColumn)) << 32 | static_cast< std::uint32_t >( aRow);
+			}
+			/**
+			 *
+			 */
+			int getBucket( int aCoordinate) const;
+			/**
+			 * Calls aVisitor with the key of every bucket that the line from aPoint1 to aPoint2, widened by
+			 * aMargin, passes through
+			 */
+			void forEachBucket(	const Point& aPoint1,
+								const Point& aPoint2,
+								int aMargin,
+								const std::function< void( std::uint64_t) >& aVisitor) const;
+			/**
+			 * Appends the walls of the buckets that the widened line passes through to aWalls, every wall once
+			 */
+			void collect(	const Point& aPoint1,
+							const Point& aPoint2,
+							int aMargin,
+							std::vector< WallPtr >& aWalls) const;
+
+			/**
+			 *
+			 * @return true if the line from aPoint1 to aPoint2 passes through the rectangle from (aLeft,aTop)
+			 * 			to (aRight,aBottom), the clipping of Liang and Barsky
+			 */
+			static bool crosses(	const Point& aPoint1,
+									const Point& aPoint2,
+									double aLeft,
+									double aTop,
+									double aRight,
+									double aBottom);
+			/**
+			 *
+			 * @return The square of the distance of aPoint to the line from aPoint1 to aPoint2
+			 */
+			static double getSquaredDistance(	const Point& aPoint,
+												const Point& aPoint1,
+												const Point& aPoint2);
+			/**
+			 *
+			 * @return The square of the distance between the lines from aPoint1 to aPoint2 and from aPoint3
+			 * 			to aPoint4, 0 if they cross or touch
+			 */
+			static double getSquaredDistance(	const Point& aPoint1,
+												const Point& aPoint2,
+												const Point& aPoint3,
+												const Point& aPoint4);
+
+			int bucketSize;
+			std::unordered_map< std::uint64_t, Bucket > buckets;
+			std::size_t numberOfWalls;
+	};
+	//	class WallIndex
+} // namespace Model
+#endif // WALLINDEX_HPP_
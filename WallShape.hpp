@@ -74,6 +74,13 @@ namespace View
 			 */
 			virtual bool occupies( const Point& aPoint) const;
 			//@}
+			/**
+			 *
+			 */
+			virtual bool isWallShape() const
+			{
+				return true;
+			}
 			/**
 			 * @name Debug functions
 			 */
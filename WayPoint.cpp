@@ -76,31 +76,6 @@ namespace Model
 			notifyObservers();
 		}
 	}
-	/**
-	 *
-	 */
-	Region WayPoint::getRegion() const
-	{
-		// x and y are pointing to top left now
-		int x = position.x - (size.x / 2);
-		int y = position.y - (size.y / 2);
-
-		Point originalUpperLeft( x, y);
-		Point originalUpperRight( x + size.x, y);
-		Point originalBottomLeft( x, y + size.y);
-		Point originalBottomRight( x + size.x, y + size.y);
-
-		Point originalPoints[] = { originalUpperRight, originalUpperLeft, originalBottomLeft, originalBottomRight };
-
-		return Region( 4, originalPoints);
-	}
-	/**
-	 *
-	 */
-	bool WayPoint::intersects( const Region& aRegion) const
-	{
-		return getRegion().Intersect( aRegion);
-	}
 	/**
 	 *
 	 */
@@ -5,7 +5,7 @@
 #include "ModelObject.hpp"
 #include "Point.hpp"
 #include "Size.hpp"
-#include "Region.hpp"
+#include "Pose.hpp"
 
 namespace Model
 {
@@ -67,12 +67,12 @@ namespace Model
 								bool aNotifyObservers = true);
 			/**
 			 *
+			 * @return The box the way point covers at its position
 			 */
-			Region getRegion() const;
-			/**
-			 *
-			 */
-			bool intersects( const Region& aRegion) const;
+			Pose getPose() const
+			{
+				return Pose( position, size);
+			}
 			/**
 			 * @name Debug functions
 			 */